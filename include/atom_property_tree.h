@@ -0,0 +1,18 @@
+#ifndef OBJECT_PROPERTY_TREE_ATOM_PROPERTY_TREE_H
+#define OBJECT_PROPERTY_TREE_ATOM_PROPERTY_TREE_H
+
+#include "key_intern_table.h"
+#include "property_tree.h"
+
+/**
+ * @brief A property tree keyed by interned names. Each node stores a 4 byte KeyAtom instead of a string and child
+ * lookups compare integers. Segment names are interned in KeyInternTable::Global() when nodes are added, string paths
+ * are accepted everywhere and an interned CompiledPath skips the name lookup altogether.
+ * @tparam T The type of the value.
+ * @tparam C The children container policy of the nodes, see node_children.h.
+ * @tparam A The node allocation policy, see node_allocator.h.
+ */
+template<typename T, typename C = MapChildren, typename A = HeapAllocation>
+using AtomPropertyTree = PropertyTree<KeyAtom, T, C, A>;
+
+#endif //OBJECT_PROPERTY_TREE_ATOM_PROPERTY_TREE_H
@@ -0,0 +1,100 @@
+#ifndef OBJECT_PROPERTY_TREE_ATOMIC_LEAF_H
+#define OBJECT_PROPERTY_TREE_ATOMIC_LEAF_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Check if a type can be held by an AtomicLeaf.
+ * @tparam V The type.
+ */
+template<typename V>
+struct IsAtomicLeafType : std::integral_constant<bool, std::is_same<V, std::int64_t>::value
+    || std::is_same<V, double>::value || std::is_same<V, bool>::value> {};
+
+/**
+ * @brief The shared cell of an atomic leaf, stored as the data of its node.
+ * @tparam V The type of the value.
+ */
+template<typename V>
+using AtomicCell = std::shared_ptr<std::atomic<V>>;
+
+/**
+ * @brief A handle to a leaf that holds an atomic scalar, see ObjectPropertyTree::GetAtomic. The handle shares the cell
+ * with the node, so updates through it take no tree lock and stay safe after the node is removed; they then no longer
+ * reach the tree. Updates do not advance the generation of the tree or notify subscribers.
+ * @tparam V The type of the value: std::int64_t, double or bool.
+ */
+template<typename V>
+class AtomicLeaf {
+  static_assert(IsAtomicLeafType<V>::value, "atomic leaves hold std::int64_t, double or bool");
+
+  AtomicCell<V> cell_; ///< The cell shared with the node.
+
+ public:
+  /**
+   * @brief Create an empty handle.
+   */
+  AtomicLeaf() = default;
+
+  /**
+   * @brief Create a handle to a cell.
+   * @param cell The cell.
+   */
+  explicit AtomicLeaf(AtomicCell<V> cell) : cell_(std::move(cell)) {}
+
+  /**
+   * @return true if the handle refers to a cell.
+   */
+  explicit operator bool() const { return cell_ != nullptr; }
+
+  /**
+   * @param order The memory order.
+   * @return The value.
+   */
+  V load(std::memory_order order = std::memory_order_seq_cst) const { return cell_->load(order); }
+
+  /**
+   * @brief Set the value.
+   * @param value The value.
+   * @param order The memory order.
+   */
+  void store(V value, std::memory_order order = std::memory_order_seq_cst) { cell_->store(value, order); }
+
+  /**
+   * @brief Set the value and return the previous one.
+   * @param value The value.
+   * @param order The memory order.
+   * @return The previous value.
+   */
+  V exchange(V value, std::memory_order order = std::memory_order_seq_cst) { return cell_->exchange(value, order); }
+
+  /**
+   * @brief Add to the value.
+   * @param delta The amount to add.
+   * @return The previous value.
+   */
+  template<typename U = V>
+  typename std::enable_if<!std::is_same<U, bool>::value, V>::type fetch_add(V delta) {
+    return FetchAdd(*cell_, delta, std::is_integral<V>());
+  }
+
+ private:
+  /**
+   * @brief Add to an integer.
+   */
+  static V FetchAdd(std::atomic<V> &cell, V delta, std::true_type) { return cell.fetch_add(delta); }
+
+  /**
+   * @brief Add to a floating point value, which has no fetch_add before C++20.
+   */
+  static V FetchAdd(std::atomic<V> &cell, V delta, std::false_type) {
+    V value = cell.load(std::memory_order_relaxed);
+    while (!cell.compare_exchange_weak(value, value + delta)) {}
+    return value;
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_ATOMIC_LEAF_H
@@ -0,0 +1,161 @@
+#ifndef OBJECT_PROPERTY_TREE_COMPILED_PATH_H
+#define OBJECT_PROPERTY_TREE_COMPILED_PATH_H
+
+#include <string>
+#include <vector>
+#include "node_key.h"
+#include "path_tokenizer.h"
+
+/**
+ * @brief A segment of a compiled path. It is a view into the path string with the hash of the segment precomputed.
+ */
+struct CompiledSegment : public boost::string_view {
+  std::size_t hash = 0; ///< NodeKeyHash of the segment.
+  KeyAtom atom; ///< The interned segment, set by CompiledPath::Intern.
+
+  /**
+   * @brief Create an empty segment.
+   */
+  CompiledSegment() = default;
+
+  /**
+   * @brief Create a segment and compute its hash.
+   * @param segment The segment.
+   */
+  explicit CompiledSegment(boost::string_view segment) : boost::string_view(segment), hash(NodeKeyHash()(segment)) {}
+};
+
+/**
+ * @brief A path that is parsed once and can then be used for any number of lookups. Use it for paths that are resolved
+ * repeatedly, the tree accessors walk the precomputed segments without tokenizing the path again.
+ */
+class CompiledPath {
+  std::string path_; ///< The path string the segments point into.
+  std::vector<CompiledSegment> segments_; ///< The parsed segments.
+
+  /**
+   * @brief Parse the path string into segments.
+   * @param separator The separator between fields.
+   */
+  void Compile(const char *separator = DEFAULT_SEPARATOR) {
+    segments_.clear();
+    for (auto segment : PathTokenizer(path_, separator)) {
+      segments_.emplace_back(segment);
+    }
+  }
+
+ public:
+  typedef CompiledSegment value_type;
+  typedef std::vector<CompiledSegment>::const_iterator iterator;
+  typedef iterator const_iterator;
+
+  /**
+   * @brief Create an empty path.
+   */
+  CompiledPath() = default;
+
+  /**
+   * @brief Parse a path.
+   * @param path The path to parse.
+   * @param separator The separator between fields.
+   */
+  explicit CompiledPath(boost::string_view path, const char *separator = DEFAULT_SEPARATOR)
+      : path_(path.data(), path.size()) {
+    Compile(separator);
+  }
+
+  /**
+   * @brief Copy a compiled path. The segments are re-pointed at the copied string.
+   * @param other The path to copy.
+   */
+  CompiledPath(const CompiledPath &other) : path_(other.path_), segments_(other.segments_) { Rebase(other); }
+
+  /**
+   * @brief Move a compiled path. The segments are re-pointed at the moved string.
+   * @param other The path to move.
+   */
+  CompiledPath(CompiledPath &&other) noexcept : path_(), segments_() { *this = std::move(other); }
+
+  CompiledPath &operator=(const CompiledPath &other) {
+    if (this != &other) {
+      path_ = other.path_;
+      segments_ = other.segments_;
+      Rebase(other);
+    }
+    return *this;
+  }
+
+  CompiledPath &operator=(CompiledPath &&other) noexcept {
+    if (this != &other) {
+      const char *old_data = other.path_.data();
+      path_ = std::move(other.path_);
+      segments_ = std::move(other.segments_);
+      Rebase(old_data);
+      other.path_.clear();
+      other.segments_.clear();
+    }
+    return *this;
+  }
+
+  /**
+   * @return The path string.
+   */
+  const std::string &str() const { return path_; }
+
+  iterator begin() const { return segments_.begin(); }
+  iterator end() const { return segments_.end(); }
+  std::size_t size() const { return segments_.size(); }
+  bool empty() const { return segments_.empty(); }
+  const CompiledSegment &operator[](std::size_t i) const { return segments_[i]; }
+
+  /**
+   * @brief Intern the segments in the global KeyInternTable so that atom keyed trees compare ids instead of looking up
+   * the segment names on every access.
+   * @return This path.
+   */
+  CompiledPath &Intern();
+
+  /**
+   * @return A span over the segments.
+   */
+  PathSpan<CompiledSegment> span() const { return PathSpan<CompiledSegment>(segments_); }
+
+ private:
+  /**
+   * @brief Re-point copied segments from another path's string to this one.
+   * @param other The path the segments were copied from.
+   */
+  void Rebase(const CompiledPath &other) { Rebase(other.path_.data()); }
+
+  /**
+   * @brief Re-point the segments from an old string buffer to this path's string.
+   * @param old_data The buffer the segments currently point into.
+   */
+  void Rebase(const char *old_data) {
+    for (auto &segment : segments_) {
+      auto offset = static_cast<std::size_t>(segment.data() - old_data);
+      static_cast<boost::string_view &>(segment) = boost::string_view(path_.data() + offset, segment.size());
+    }
+  }
+};
+
+inline std::size_t NodeKeyHash::operator()(const CompiledSegment &segment) const {
+  return segment.hash;
+}
+
+inline KeyAtom NodeKeyTraits<KeyAtom>::Make(const CompiledSegment &segment) {
+  return segment.atom ? segment.atom : Make(boost::string_view(segment));
+}
+
+inline KeyAtom NodeKeyTraits<KeyAtom>::Lookup(const CompiledSegment &segment) {
+  return segment.atom ? segment.atom : Lookup(boost::string_view(segment));
+}
+
+/**
+ * @brief Get the segments of a path, see path_tokenizer.h.
+ * @param path A path.
+ * @return The path.
+ */
+inline const CompiledPath &PathSegments(const CompiledPath &path) { return path; }
+
+#endif //OBJECT_PROPERTY_TREE_COMPILED_PATH_H
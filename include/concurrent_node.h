@@ -0,0 +1,118 @@
+#ifndef OBJECT_PROPERTY_TREE_CONCURRENT_NODE_H
+#define OBJECT_PROPERTY_TREE_CONCURRENT_NODE_H
+
+#include <boost/thread/shared_mutex.hpp>
+#include "node_children.h"
+#include "node_key.h"
+
+/**
+ * @brief A node of a ConcurrentPropertyTree. Each node carries two locks: the structure lock guards the child map and
+ * the data lock guards the data. The data lock is only taken while the structure lock is held, so holding the structure
+ * lock exclusively keeps every other thread away from the node. The node itself does no locking, the tree takes the
+ * locks as it walks, see concurrent_property_tree.h.
+ * @tparam K The type of the node name.
+ * @tparam T The type of the node data.
+ * @tparam C The children container policy, see node_children.h.
+ */
+template<typename K, typename T, typename C = MapChildren>
+class ConcurrentNode {
+ public:
+  typedef typename C::template Container<K, ConcurrentNode *> ChildMap; ///< map of children, searchable by path segments.
+
+ private:
+  K name_; ///< The name of the node.
+  T data_; ///< The leaf data, guarded by data_mutex_.
+  ConcurrentNode *parent_ = nullptr; ///< The node's parent.
+  ChildMap children_; ///< The children, guarded by mutex_.
+  mutable boost::shared_mutex mutex_; ///< The structure lock.
+  mutable boost::shared_mutex data_mutex_; ///< The data lock.
+
+ public:
+  /**
+   * @brief Create a node.
+   * @param name The name of the node.
+   * @param parent A pointer to the parent node.
+   */
+  explicit ConcurrentNode(const K &name, ConcurrentNode *parent = nullptr) : name_(name), parent_(parent) {}
+
+  ConcurrentNode(const ConcurrentNode &) = delete;
+  ConcurrentNode &operator=(const ConcurrentNode &) = delete;
+
+  /**
+   * @return The structure lock, guarding the children.
+   */
+  boost::shared_mutex &mutex() const { return mutex_; }
+
+  /**
+   * @return The data lock, guarding the data.
+   */
+  boost::shared_mutex &data_mutex() const { return data_mutex_; }
+
+  /**
+   * @return The name of the node.
+   */
+  const K &name() const { return name_; }
+
+  /**
+   * @return A pointer to the parent.
+   */
+  ConcurrentNode *parent() const { return parent_; }
+
+  /**
+   * @return reference to the node data. The data lock must be held.
+   */
+  T &data() { return data_; }
+
+  /**
+   * @return The dictionary of children. The structure lock must be held.
+   */
+  ChildMap &children() { return children_; }
+
+  /**
+   * @brief Look up a direct child. The structure lock must be held, shared or exclusive.
+   * @tparam S The segment type, anything comparable with K.
+   * @param segment The name of the child.
+   * @return pointer to the child or nullptr.
+   */
+  template<typename S>
+  ConcurrentNode *FindChild(const S &segment) {
+    auto i = children_.find(NodeKeyTraits<K>::Lookup(segment));
+    return i == children_.end() ? nullptr : i->second;
+  }
+
+  /**
+   * @brief Get a direct child, creating it if it is missing. The structure lock must be held exclusively.
+   * @tparam S The segment type, anything comparable with K.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param segment The name of the child.
+   * @param allocator The allocator to create the child with.
+   * @return pointer to the child.
+   */
+  template<typename S, typename A>
+  ConcurrentNode *FindOrCreateChild(const S &segment, A &allocator) {
+    ConcurrentNode *child = FindChild(segment);
+    if (!child) {
+      child = allocator.Create(NodeKeyTraits<K>::Make(segment), this);
+      children_.emplace(child->name(), child);
+    }
+    return child;
+  }
+
+  /**
+   * @brief Detach a direct child. The structure lock must be held exclusively.
+   * @tparam S The segment type, anything comparable with K.
+   * @param segment The name of the child.
+   * @return pointer to the detached child or nullptr.
+   */
+  template<typename S>
+  ConcurrentNode *DetachChild(const S &segment) {
+    auto i = children_.find(NodeKeyTraits<K>::Lookup(segment));
+    if (i == children_.end()) return nullptr;
+    ConcurrentNode *child = i->second;
+    children_.erase(i);
+    child->parent_ = nullptr;
+    return child;
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_CONCURRENT_NODE_H
@@ -0,0 +1,328 @@
+#ifndef OBJECT_PROPERTY_TREE_CONCURRENT_PROPERTY_TREE_H
+#define OBJECT_PROPERTY_TREE_CONCURRENT_PROPERTY_TREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "compiled_path.h"
+#include "concurrent_node.h"
+#include "node_allocator.h"
+#include "node_path.h"
+
+/**
+ * @brief A property tree with a reader/writer lock per node instead of one for the whole tree, so writers only block
+ * the threads that use the same nodes. Updating "sensors.a.value" leaves readers of "config" running.
+ *
+ * Paths are walked with lock coupling: the lock of a child is taken before the lock of its parent is released, so a
+ * node cannot be removed under a thread that is walking through it. Walks take the structure locks shared. A missing
+ * child is created by retaking the structure lock of its parent exclusively, while the lock of the grandparent keeps
+ * the parent attached. Data is read and written under the data lock of the leaf alone. Removing a node takes its
+ * parent exclusively, detaches it and then takes each node of the detached subtree exclusively before destroying it,
+ * which waits for the threads still inside.
+ *
+ * All locks are taken from the root down, so threads cannot deadlock. Nodes are not handed out, because they may be
+ * removed as soon as their locks are released; data is copied in and out instead.
+ * @tparam K The type of the key.
+ * @tparam T The type of the value.
+ * @tparam C The children container policy of the nodes, see node_children.h.
+ * @tparam A The node allocation policy, see node_allocator.h. The allocator is serialised.
+ */
+template<typename K, typename T, typename C = MapChildren, typename A = HeapAllocation>
+class ConcurrentPropertyTree {
+ public:
+  /**
+   * @brief A node type with matching key and value types.
+   */
+  typedef ConcurrentNode<K, T, C> PropertyNode;
+
+  /**
+   * @brief A node path type with matching key type.
+   */
+  typedef NodePath<K> Path;
+
+  /**
+   * @brief The allocator of the nodes.
+   */
+  typedef SynchronizedAllocator<typename A::template Allocator<PropertyNode>> NodeAllocator;
+
+ private:
+  /**
+   * @brief Holds the structure lock of a node, shared or exclusive.
+   */
+  class NodeLock {
+    boost::shared_mutex *mutex_ = nullptr; ///< The locked mutex or nullptr.
+    bool exclusive_ = false; ///< The lock is exclusive.
+
+   public:
+    NodeLock() = default;
+
+    NodeLock(PropertyNode *node, bool exclusive) : mutex_(&node->mutex()), exclusive_(exclusive) {
+      if (exclusive_) {
+        mutex_->lock();
+      } else {
+        mutex_->lock_shared();
+      }
+    }
+
+    NodeLock(NodeLock &&other) noexcept : mutex_(other.mutex_), exclusive_(other.exclusive_) { other.mutex_ = nullptr; }
+
+    NodeLock &operator=(NodeLock &&other) noexcept {
+      if (this != &other) {
+        unlock();
+        std::swap(mutex_, other.mutex_);
+        exclusive_ = other.exclusive_;
+      }
+      return *this;
+    }
+
+    ~NodeLock() { unlock(); }
+
+    void unlock() {
+      if (mutex_) {
+        if (exclusive_) {
+          mutex_->unlock();
+        } else {
+          mutex_->unlock_shared();
+        }
+        mutex_ = nullptr;
+      }
+    }
+  };
+
+  typedef boost::shared_lock<boost::shared_mutex> DataReadLock;
+  typedef boost::unique_lock<boost::shared_mutex> DataWriteLock;
+
+  NodeAllocator allocator_; ///< Creates and destroys the nodes below the root.
+  PropertyNode root_; ///< The root node.
+  std::atomic<bool> changed_{false}; ///< Track if any action may have changed the tree.
+
+ public:
+  /**
+   * @brief Create a property tree.
+   */
+  ConcurrentPropertyTree() : root_(NodeKeyTraits<K>::Make("__ROOT__")) {}
+
+  ConcurrentPropertyTree(const ConcurrentPropertyTree &) = delete;
+  ConcurrentPropertyTree &operator=(const ConcurrentPropertyTree &) = delete;
+
+  /**
+   * @brief Delete the property tree. No other thread may be using it.
+   */
+  virtual ~ConcurrentPropertyTree() {
+    NodeLock lock(&root_, true);
+    DestroyChildren(&root_);
+    lock.unlock();
+    allocator_.Release();
+  }
+
+  /**
+   * @return The changed flag. True if something has changed.
+   */
+  bool changed() const { return changed_; }
+
+  /**
+   * @brief Set changed to false.
+   */
+  void ClearChanged() { changed_ = false; }
+
+  /**
+   * @brief Set the changed flag. Default is true.
+   * @param changed The flag to set.
+   */
+  void SetChanged(bool changed = true) { changed_ = changed; }
+
+  /**
+   * @brief Clear / delete all nodes (other than root) from the tree.
+   */
+  void clear() {
+    NodeLock lock(&root_, true);
+    DestroyChildren(&root_);
+    SetChanged();
+  }
+
+  /**
+   * @brief Set data for a node. Path is created if necessary.
+   * @tparam P Path type.
+   * @param path The path of the node to set.
+   * @param data The data to set at path.
+   */
+  template<typename P>
+  void SetData(const P &path, const T &data) {
+    auto &&segments = PathSegments(path);
+    auto segment = segments.begin();
+    auto end = segments.end();
+    if (segment == end) return;
+    PropertyNode *node = &root_;
+    NodeLock parent_lock;
+    NodeLock lock(node, false);
+    for (; segment != end; ++segment) {
+      PropertyNode *child = node->FindChild(*segment);
+      if (!child) {
+        // parent_lock keeps node attached while its lock is retaken exclusively.
+        lock.unlock();
+        lock = NodeLock(node, true);
+        child = node->FindOrCreateChild(*segment, allocator_);
+      }
+      parent_lock = std::move(lock);
+      lock = NodeLock(child, false);
+      node = child;
+    }
+    parent_lock.unlock();
+    DataWriteLock data_lock(node->data_mutex());
+    node->data() = data;
+    SetChanged();
+  }
+
+  /**
+   * @brief Get a copy of the data at a path.
+   * @tparam P Path type.
+   * @param path The path of the object to get.
+   * @param data A reference to collect the data object.
+   * @return true if a node exists at path.
+   */
+  template<typename P>
+  bool GetData(const P &path, T &data) {
+    return Walk(path, [&data](PropertyNode *node) {
+      DataReadLock data_lock(node->data_mutex());
+      data = node->data();
+    });
+  }
+
+  /**
+   * @brief Check if a node exists at the path.
+   * @tparam P Path type.
+   * @param path The path of the check.
+   * @return true if a node exists at path.
+   */
+  template<typename P>
+  bool exists(const P &path) {
+    return Walk(path, [](PropertyNode *) {});
+  }
+
+  /**
+   * @brief Remove the node at path from the tree. Waits for the threads using the node or its descendants.
+   * @tparam P Path type.
+   * @param path The path of the node to remove.
+   */
+  template<typename P>
+  void remove(const P &path) {
+    auto &&segments = PathSegments(path);
+    auto segment = segments.begin();
+    auto end = segments.end();
+    if (segment == end) return;
+    PropertyNode *node = &root_;
+    NodeLock parent_lock;
+    NodeLock lock(node, false);
+    for (auto next = std::next(segment); next != end; segment = next, ++next) {
+      PropertyNode *child = node->FindChild(*segment);
+      if (!child) return;
+      parent_lock = std::move(lock);
+      lock = NodeLock(child, false);
+      node = child;
+    }
+    lock.unlock();
+    lock = NodeLock(node, true);
+    parent_lock.unlock();
+    PropertyNode *child = node->DetachChild(*segment);
+    if (child) {
+      // Any thread inside child locked it before node was taken, wait for them to move on before letting go of node.
+      NodeLock child_lock(child, true);
+      lock.unlock();
+      DestroyChildren(child);
+      child_lock.unlock();
+      allocator_.Destroy(child);
+      SetChanged();
+    }
+  }
+
+  /**
+   * @brief List the children of a node
+   * @tparam P The path type.
+   * @param path The path of the node to list.
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list.
+   */
+  template<typename P>
+  unsigned long ListChildren(const P &path, std::vector<K> &children_list, bool sorted = false) {
+    children_list.clear();
+    Walk(path, [&children_list](PropertyNode *node) { CopyNames(node, children_list); });
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
+    return children_list.size();
+  }
+
+  /**
+   * @brief List the children of the root node
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list.
+   */
+  unsigned long ListChildren(std::vector<K> &children_list, bool sorted = false) {
+    children_list.clear();
+    {
+      NodeLock lock(&root_, false);
+      CopyNames(&root_, children_list);
+    }
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
+    return children_list.size();
+  }
+
+ private:
+  /**
+   * @brief Walk to the node at a path with shared lock coupling and call a function on it.
+   * @tparam P Path type.
+   * @tparam F The function type.
+   * @param path The path of the node.
+   * @param f Called with the node while its structure lock is held shared.
+   * @return true if a node exists at path.
+   */
+  template<typename P, typename F>
+  bool Walk(const P &path, F f) {
+    auto &&segments = PathSegments(path);
+    auto segment = segments.begin();
+    auto end = segments.end();
+    if (segment == end) return false;
+    PropertyNode *node = &root_;
+    NodeLock lock(node, false);
+    for (; segment != end; ++segment) {
+      PropertyNode *child = node->FindChild(*segment);
+      if (!child) return false;
+      NodeLock child_lock(child, false);
+      std::swap(lock, child_lock);
+      node = child;
+    }
+    f(node);
+    return true;
+  }
+
+  /**
+   * @brief Copy the names of the children of a node. Its structure lock must be held.
+   * @param node The node.
+   * @param children_list receives the names.
+   */
+  static void CopyNames(PropertyNode *node, std::vector<K> &children_list) {
+    for (auto i = node->children().begin(); i != node->children().end(); i++) {
+      children_list.push_back(i->first);
+    }
+  }
+
+  /**
+   * @brief Destroy the children of a node and their descendants. The structure lock of the node must be held
+   * exclusively, so no other thread can reach the children; each child is still locked exclusively before it is
+   * destroyed, to wait for the threads that are already inside it.
+   * @param node The node.
+   */
+  void DestroyChildren(PropertyNode *node) {
+    for (auto i = node->children().begin(); i != node->children().end(); i++) {
+      PropertyNode *child = i->second;
+      NodeLock child_lock(child, true);
+      DestroyChildren(child);
+      child_lock.unlock();
+      allocator_.Destroy(child);
+    }
+    node->children().clear();
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_CONCURRENT_PROPERTY_TREE_H
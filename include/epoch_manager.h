@@ -0,0 +1,140 @@
+#ifndef OBJECT_PROPERTY_TREE_EPOCH_MANAGER_H
+#define OBJECT_PROPERTY_TREE_EPOCH_MANAGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Epoch-based reclamation for structures that are read without locks. Readers announce the epoch they entered
+ * in; memory unlinked by a writer is retired with the epoch it was unlinked in and freed once every reader that could
+ * still see it has left. Entering and leaving are a store to a slot of the calling thread, readers never write shared
+ * cache lines.
+ *
+ * There is one manager per process, shared by all epoch trees. A thread takes a slot on its first Enter and gives it
+ * back when it exits.
+ */
+class EpochManager {
+ public:
+  /**
+   * @brief The maximum number of threads that can be inside the manager at the same time.
+   */
+  static constexpr std::size_t MAX_THREADS = 256;
+
+  /**
+   * @brief Keeps the calling thread in an epoch for its lifetime. Guards nest.
+   */
+  class Guard {
+    EpochManager &manager_; ///< The manager.
+
+   public:
+    explicit Guard(EpochManager &manager = Global()) : manager_(manager) { manager_.Enter(); }
+    ~Guard() { manager_.Exit(); }
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+  };
+
+  /**
+   * @brief The announcement of one thread, on its own cache line.
+   */
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> epoch{0}; ///< The epoch the thread entered in or 0 outside.
+    std::atomic<bool> used{false}; ///< The slot belongs to a thread.
+    unsigned depth = 0; ///< The nesting depth of Enter, only used by the owning thread.
+  };
+
+  EpochManager(const EpochManager &) = delete;
+  EpochManager &operator=(const EpochManager &) = delete;
+
+  /**
+   * @brief Free everything that is still retired. No thread may be inside the manager.
+   */
+  ~EpochManager();
+
+  /**
+   * @return The manager of the process.
+   */
+  static EpochManager &Global();
+
+  /**
+   * @brief Enter the current epoch. Memory retired from now on is not freed until the thread calls Exit.
+   */
+  void Enter();
+
+  /**
+   * @brief Leave the epoch entered by the matching Enter.
+   */
+  void Exit();
+
+  /**
+   * @brief Free memory once no reader can see it any more.
+   * @param pointer The memory. It must already be unreachable for readers that enter from now on.
+   * @param deleter Frees the memory.
+   */
+  void Retire(void *pointer, void (*deleter)(void *));
+
+  /**
+   * @brief Delete an object once no reader can see it any more.
+   * @tparam T The object type.
+   * @param object The object. It must already be unreachable for readers that enter from now on.
+   */
+  template<typename T>
+  void Retire(T *object) {
+    Retire(const_cast<void *>(static_cast<const void *>(object)),
+           [](void *pointer) { delete static_cast<T *>(pointer); });
+  }
+
+  /**
+   * @brief Free the retired memory that no reader can see any more.
+   * @return The number of retired items freed.
+   */
+  std::size_t Reclaim();
+
+  /**
+   * @return The number of retired items not freed yet.
+   */
+  std::size_t pending() const;
+
+ private:
+  /**
+   * @brief Memory waiting to be freed.
+   */
+  struct Retired {
+    void *pointer; ///< The memory.
+    void (*deleter)(void *); ///< Frees the memory.
+    std::uint64_t epoch; ///< The epoch the memory was retired in.
+  };
+
+  /**
+   * @brief Retired items are reclaimed every time this many have piled up.
+   */
+  static constexpr std::size_t RECLAIM_THRESHOLD = 64;
+
+  Slot slots_[MAX_THREADS]; ///< The announcements of the threads.
+  std::atomic<std::uint64_t> epoch_{1}; ///< The current epoch.
+  mutable std::mutex retired_mutex_; ///< Guards retired_.
+  std::vector<Retired> retired_; ///< The retired items.
+
+  EpochManager() = default;
+
+  /**
+   * @return The slot of the calling thread, taken on first use.
+   */
+  Slot &ThreadSlot();
+
+  /**
+   * @brief Take the retired items that no reader can see out of the list. retired_mutex_ must be held.
+   * @return The items, to free once the mutex is released.
+   */
+  std::vector<Retired> CollectLocked();
+
+  /**
+   * @brief Free retired items. retired_mutex_ must not be held, so deleters may retire more memory.
+   * @param retired The items.
+   */
+  static void Free(const std::vector<Retired> &retired);
+};
+
+#endif //OBJECT_PROPERTY_TREE_EPOCH_MANAGER_H
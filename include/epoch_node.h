@@ -0,0 +1,121 @@
+#ifndef OBJECT_PROPERTY_TREE_EPOCH_NODE_H
+#define OBJECT_PROPERTY_TREE_EPOCH_NODE_H
+
+#include <atomic>
+#include "node_children.h"
+#include "node_key.h"
+
+/**
+ * @brief A node of an EpochPropertyTree. The child map and the data are immutable once published and are replaced
+ * as a whole by the writer, so readers can follow them without locks. Replaced maps and data are retired to the
+ * EpochManager by the tree.
+ * @tparam K The type of the node name.
+ * @tparam T The type of the node data.
+ * @tparam C The children container policy, see node_children.h.
+ */
+template<typename K, typename T, typename C = MapChildren>
+class EpochNode {
+ public:
+  typedef typename C::template Container<K, EpochNode *> ChildMap; ///< map of children, searchable by path segments.
+
+ private:
+  K name_; ///< The name of the node.
+  std::atomic<const T *> data_{nullptr}; ///< The leaf data or nullptr for default data.
+  std::atomic<const ChildMap *> children_{nullptr}; ///< The children or nullptr if there are none.
+
+ public:
+  /**
+   * @brief Create a node.
+   * @param name The name of the node.
+   */
+  explicit EpochNode(const K &name) : name_(name) {}
+
+  EpochNode(const EpochNode &) = delete;
+  EpochNode &operator=(const EpochNode &) = delete;
+
+  /**
+   * @brief Delete the node, its data and its descendants.
+   */
+  ~EpochNode() {
+    delete data_.load();
+    const ChildMap *children = children_.load();
+    if (children) {
+      for (auto i = children->begin(); i != children->end(); i++) {
+        delete i->second;
+      }
+      delete children;
+    }
+  }
+
+  /**
+   * @return The name of the node
+   */
+  const K &name() const { return name_; }
+
+  /**
+   * @return The leaf data or nullptr for default data.
+   */
+  const T *data() const { return data_.load(std::memory_order_acquire); }
+
+  /**
+   * @return The children or nullptr if there are none.
+   */
+  const ChildMap *children() const { return children_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Look up a direct child.
+   * @tparam S The segment type, anything comparable with K.
+   * @param segment The name of the child.
+   * @return pointer to the child or nullptr.
+   */
+  template<typename S>
+  EpochNode *FindChild(const S &segment) const {
+    const ChildMap *children = this->children();
+    if (!children) return nullptr;
+    auto i = children->find(NodeKeyTraits<K>::Lookup(segment));
+    return i == children->end() ? nullptr : i->second;
+  }
+
+  /**
+   * @brief Publish new data. Only the writer may call this.
+   * @param data The new data, owned by the node.
+   * @return The replaced data, to be retired, or nullptr.
+   */
+  const T *ExchangeData(const T *data) { return data_.exchange(data, std::memory_order_acq_rel); }
+
+  /**
+   * @brief Publish a copy of the child map with a child added. Only the writer may call this.
+   * @param child The child, owned by the node. There must not be a child with the same name.
+   * @return The replaced child map, to be retired, or nullptr.
+   */
+  const ChildMap *AddChild(EpochNode *child) {
+    const ChildMap *children = this->children();
+    ChildMap *copy = children ? new ChildMap(*children) : new ChildMap();
+    copy->emplace(child->name(), child);
+    return children_.exchange(copy, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @brief Publish a copy of the child map with a child removed. Only the writer may call this.
+   * @tparam S The segment type, anything comparable with K.
+   * @param segment The name of the child.
+   * @param child Receives the removed child, to be retired, or nullptr.
+   * @return The replaced child map, to be retired, or nullptr if nothing was removed.
+   */
+  template<typename S>
+  const ChildMap *RemoveChild(const S &segment, EpochNode *&child) {
+    child = FindChild(segment);
+    if (!child) return nullptr;
+    ChildMap *copy = new ChildMap(*children());
+    copy->erase(child->name());
+    return children_.exchange(copy, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @brief Unpublish all children. Only the writer may call this.
+   * @return The replaced child map, to be retired with the children, or nullptr.
+   */
+  const ChildMap *RemoveChildren() { return children_.exchange(nullptr, std::memory_order_acq_rel); }
+};
+
+#endif //OBJECT_PROPERTY_TREE_EPOCH_NODE_H
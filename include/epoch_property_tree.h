@@ -0,0 +1,262 @@
+#ifndef OBJECT_PROPERTY_TREE_EPOCH_PROPERTY_TREE_H
+#define OBJECT_PROPERTY_TREE_EPOCH_PROPERTY_TREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "compiled_path.h"
+#include "epoch_manager.h"
+#include "epoch_node.h"
+#include "node_path.h"
+
+/**
+ * @brief A property tree whose readers take no locks. Child maps and data are copy-on-write: the writer builds a
+ * replacement, publishes it with an atomic store and retires the old one to the EpochManager, which frees it once
+ * every reader that could still see it has left. Removed nodes are retired the same way, so a reader never sees freed
+ * memory. Readers only announce their epoch in a slot of their own thread.
+ *
+ * Writers are serialised by one mutex and pay for the copies: adding or removing a child copies the child map of its
+ * parent, so the tree suits data that is read far more often than its shape changes. A new branch is built before it
+ * is attached, so readers see it whole.
+ * @tparam K The type of the key.
+ * @tparam T The type of the value.
+ * @tparam C The children container policy of the nodes, see node_children.h.
+ */
+template<typename K, typename T, typename C = MapChildren>
+class EpochPropertyTree {
+ public:
+  /**
+   * @brief A node type with matching key and value types.
+   */
+  typedef EpochNode<K, T, C> PropertyNode;
+
+  /**
+   * @brief A node path type with matching key type.
+   */
+  typedef NodePath<K> Path;
+
+ private:
+  std::mutex write_mutex_; ///< Serialises the writers.
+  PropertyNode root_; ///< The root node.
+  std::atomic<bool> changed_{false}; ///< Track if any action may have changed the tree.
+
+ public:
+  /**
+   * @brief Create a property tree.
+   */
+  EpochPropertyTree() : root_(NodeKeyTraits<K>::Make("__ROOT__")) {}
+
+  EpochPropertyTree(const EpochPropertyTree &) = delete;
+  EpochPropertyTree &operator=(const EpochPropertyTree &) = delete;
+
+  /**
+   * @brief Delete the property tree. No other thread may be using it. Retired nodes are freed by the EpochManager.
+   */
+  virtual ~EpochPropertyTree() = default;
+
+  /**
+   * @return The changed flag. True if something has changed.
+   */
+  bool changed() const { return changed_; }
+
+  /**
+   * @brief Set changed to false.
+   */
+  void ClearChanged() { changed_ = false; }
+
+  /**
+   * @brief Set the changed flag. Default is true.
+   * @param changed The flag to set.
+   */
+  void SetChanged(bool changed = true) { changed_ = changed; }
+
+  /**
+   * @brief Clear / delete all nodes (other than root) from the tree. Readers inside the tree keep seeing the old nodes.
+   */
+  void clear() {
+    std::lock_guard<std::mutex> l(write_mutex_);
+    const typename PropertyNode::ChildMap *children = root_.RemoveChildren();
+    if (children) {
+      for (auto i = children->begin(); i != children->end(); i++) {
+        EpochManager::Global().Retire(i->second);
+      }
+      EpochManager::Global().Retire(children);
+    }
+    SetChanged();
+  }
+
+  /**
+   * @brief Set data for a node. Path is created if necessary.
+   * @tparam P Path type.
+   * @param path The path of the node to set.
+   * @param data The data to set at path.
+   */
+  template<typename P>
+  void SetData(const P &path, const T &data) {
+    auto &&segments = PathSegments(path);
+    auto segment = segments.begin();
+    auto end = segments.end();
+    if (segment == end) return;
+    std::lock_guard<std::mutex> l(write_mutex_);
+    PropertyNode *node = &root_;
+    for (; segment != end; ++segment) {
+      PropertyNode *child = node->FindChild(*segment);
+      if (!child) break;
+      node = child;
+    }
+    if (segment == end) {
+      Retire(node->ExchangeData(new T(data)));
+    } else {
+      // Build the missing branch privately and attach it with a single publish.
+      PropertyNode *branch = new PropertyNode(NodeKeyTraits<K>::Make(*segment));
+      PropertyNode *leaf = branch;
+      for (++segment; segment != end; ++segment) {
+        PropertyNode *child = new PropertyNode(NodeKeyTraits<K>::Make(*segment));
+        leaf->AddChild(child);
+        leaf = child;
+      }
+      leaf->ExchangeData(new T(data));
+      Retire(node->AddChild(branch));
+    }
+    SetChanged();
+  }
+
+  /**
+   * @brief Get a copy of the data at a path without locking.
+   * @tparam P Path type.
+   * @param path The path of the object to get.
+   * @param data A reference to collect the data object.
+   * @return true if a node exists at path.
+   */
+  template<typename P>
+  bool GetData(const P &path, T &data) {
+    EpochManager::Guard guard;
+    const PropertyNode *node = Find(path);
+    if (!node) return false;
+    const T *node_data = node->data();
+    data = node_data ? *node_data : T();
+    return true;
+  }
+
+  /**
+   * @brief Find a node by path without locking. The node is only safe to use while the calling thread holds an
+   * EpochManager::Guard, taken before the call.
+   * @tparam P Path type.
+   * @param path The path of the node to get.
+   * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
+   */
+  template<typename P>
+  const PropertyNode *Find(const P &path) const {
+    auto &&segments = PathSegments(path);
+    auto segment = segments.begin();
+    auto end = segments.end();
+    if (segment == end) return nullptr;
+    const PropertyNode *node = &root_;
+    for (; node && segment != end; ++segment) {
+      node = node->FindChild(*segment);
+    }
+    return node;
+  }
+
+  /**
+   * @brief Check if a node exists at the path.
+   * @tparam P Path type.
+   * @param path The path of the check.
+   * @return true if a node exists at path.
+   */
+  template<typename P>
+  bool exists(const P &path) {
+    EpochManager::Guard guard;
+    return Find(path) != nullptr;
+  }
+
+  /**
+   * @brief Remove the node at path from the tree. Readers inside the node keep seeing it until they leave.
+   * @tparam P Path type.
+   * @param path The path of the node to remove.
+   */
+  template<typename P>
+  void remove(const P &path) {
+    auto &&segments = PathSegments(path);
+    auto segment = segments.begin();
+    auto end = segments.end();
+    if (segment == end) return;
+    std::lock_guard<std::mutex> l(write_mutex_);
+    PropertyNode *node = &root_;
+    for (auto next = std::next(segment); next != end; segment = next, ++next) {
+      node = node->FindChild(*segment);
+      if (!node) return;
+    }
+    PropertyNode *child = nullptr;
+    auto children = node->RemoveChild(*segment, child);
+    if (child) {
+      Retire(children);
+      Retire(child);
+      SetChanged();
+    }
+  }
+
+  /**
+   * @brief List the children of a node
+   * @tparam P The path type.
+   * @param path The path of the node to list.
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list.
+   */
+  template<typename P>
+  unsigned long ListChildren(const P &path, std::vector<K> &children_list, bool sorted = false) {
+    children_list.clear();
+    {
+      EpochManager::Guard guard;
+      const PropertyNode *node = Find(path);
+      if (node) CopyNames(node, children_list);
+    }
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
+    return children_list.size();
+  }
+
+  /**
+   * @brief List the children of the root node
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list.
+   */
+  unsigned long ListChildren(std::vector<K> &children_list, bool sorted = false) {
+    children_list.clear();
+    {
+      EpochManager::Guard guard;
+      CopyNames(&root_, children_list);
+    }
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
+    return children_list.size();
+  }
+
+ private:
+  /**
+   * @brief Retire replaced data, a replaced child map or a removed node.
+   * @tparam U The type of the object.
+   * @param object The object or nullptr.
+   */
+  template<typename U>
+  static void Retire(const U *object) {
+    if (object) EpochManager::Global().Retire(object);
+  }
+
+  /**
+   * @brief Copy the names of the children of a node. The calling thread must hold an EpochManager::Guard.
+   * @param node The node.
+   * @param children_list receives the names.
+   */
+  static void CopyNames(const PropertyNode *node, std::vector<K> &children_list) {
+    auto children = node->children();
+    if (children) {
+      for (auto i = children->begin(); i != children->end(); i++) {
+        children_list.push_back(i->first);
+      }
+    }
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_EPOCH_PROPERTY_TREE_H
@@ -0,0 +1,380 @@
+#ifndef OBJECT_PROPERTY_TREE_FLAT_HASH_MAP_H
+#define OBJECT_PROPERTY_TREE_FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "node_key.h"
+
+/**
+ * @brief An open addressing hash map with linear probing. The entries are stored in one contiguous slot array next to
+ * their hashes, so a lookup is one hash and a short scan of neighbouring slots. Deleting shifts the following entries
+ * back, no tombstones are left behind. Iteration order is unspecified.
+ *
+ * Lookups are heterogeneous: any key type that Hash and Equal accept can be searched for, e.g. string views in a map of
+ * strings. Keys must not be modified through iterators.
+ * @tparam K The key type.
+ * @tparam V The mapped type.
+ * @tparam Hash The hash function.
+ * @tparam Equal The key equality function.
+ */
+template<typename K, typename V, typename Hash = NodeKeyHash, typename Equal = NodeKeyEqual>
+class FlatHashMap {
+ public:
+  typedef K key_type;
+  typedef V mapped_type;
+  typedef std::pair<K, V> value_type;
+  typedef std::size_t size_type;
+
+ private:
+  /**
+   * @brief A slot of the table. A zero hash marks an empty slot.
+   */
+  struct Slot {
+    std::size_t hash = 0; ///< The hash of the entry, never zero for a used slot.
+    typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage; ///< The entry.
+
+    value_type &entry() { return *reinterpret_cast<value_type *>(&storage); }
+    const value_type &entry() const { return *reinterpret_cast<const value_type *>(&storage); }
+  };
+
+  Slot *slots_ = nullptr; ///< The slot array, a power of two in size.
+  size_type capacity_ = 0; ///< The number of slots.
+  size_type size_ = 0; ///< The number of entries.
+  Hash hash_; ///< The hash function.
+  Equal equal_; ///< The equality function.
+
+  /**
+   * @brief Iterates the used slots.
+   * @tparam Const true for a const iterator.
+   */
+  template<bool Const>
+  class Iterator {
+    friend class FlatHashMap;
+    template<bool> friend class Iterator;
+    typedef typename std::conditional<Const, const Slot *, Slot *>::type SlotPointer;
+    SlotPointer slot_ = nullptr; ///< The current slot.
+    SlotPointer end_ = nullptr; ///< One past the last slot.
+
+    Iterator(SlotPointer slot, SlotPointer end) : slot_(slot), end_(end) { Skip(); }
+
+    /**
+     * @brief Move forward to a used slot.
+     */
+    void Skip() {
+      while (slot_ != end_ && slot_->hash == 0) ++slot_;
+    }
+
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename FlatHashMap::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<Const, const value_type *, value_type *>::type pointer;
+    typedef typename std::conditional<Const, const value_type &, value_type &>::type reference;
+
+    Iterator() = default;
+
+    /**
+     * @brief Convert an iterator to a const iterator.
+     * @param other The iterator to convert.
+     */
+    template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+    Iterator(const Iterator<OtherConst> &other) : slot_(other.slot_), end_(other.end_) {}
+
+    reference operator*() const { return slot_->entry(); }
+    pointer operator->() const { return &slot_->entry(); }
+
+    Iterator &operator++() {
+      ++slot_;
+      Skip();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator i = *this;
+      ++*this;
+      return i;
+    }
+
+    template<bool OtherConst>
+    bool operator==(const Iterator<OtherConst> &other) const { return slot_ == other.slot_; }
+
+    template<bool OtherConst>
+    bool operator!=(const Iterator<OtherConst> &other) const { return slot_ != other.slot_; }
+  };
+
+ public:
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+
+  /**
+   * @brief Create an empty map. Nothing is allocated until the first insertion.
+   */
+  FlatHashMap() = default;
+
+  /**
+   * @brief Copy a map.
+   * @param other The map to copy.
+   */
+  FlatHashMap(const FlatHashMap &other) : hash_(other.hash_), equal_(other.equal_) {
+    if (other.capacity_) {
+      Allocate(other.capacity_);
+      for (size_type i = 0; i < capacity_; i++) {
+        if (other.slots_[i].hash) {
+          new(&slots_[i].storage) value_type(other.slots_[i].entry());
+          slots_[i].hash = other.slots_[i].hash;
+        }
+      }
+      size_ = other.size_;
+    }
+  }
+
+  /**
+   * @brief Move a map.
+   * @param other The map to move, it is left empty.
+   */
+  FlatHashMap(FlatHashMap &&other) noexcept { swap(other); }
+
+  FlatHashMap &operator=(FlatHashMap other) {
+    swap(other);
+    return *this;
+  }
+
+  ~FlatHashMap() {
+    clear();
+    delete[] slots_;
+  }
+
+  /**
+   * @brief Swap the contents with another map.
+   * @param other The map to swap with.
+   */
+  void swap(FlatHashMap &other) noexcept {
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(hash_, other.hash_);
+    std::swap(equal_, other.equal_);
+  }
+
+  iterator begin() { return iterator(slots_, slots_ + capacity_); }
+  iterator end() { return iterator(slots_ + capacity_, slots_ + capacity_); }
+  const_iterator begin() const { return const_iterator(slots_, slots_ + capacity_); }
+  const_iterator end() const { return const_iterator(slots_ + capacity_, slots_ + capacity_); }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * @return The number of slots.
+   */
+  size_type bucket_count() const { return capacity_; }
+
+  /**
+   * @brief Find an entry.
+   * @tparam L The lookup key type.
+   * @param key The key to find.
+   * @return An iterator to the entry or end().
+   */
+  template<typename L>
+  iterator find(const L &key) {
+    size_type i = FindSlot(key);
+    return i == capacity_ ? end() : iterator(slots_ + i, slots_ + capacity_);
+  }
+
+  template<typename L>
+  const_iterator find(const L &key) const {
+    size_type i = FindSlot(key);
+    return i == capacity_ ? end() : const_iterator(slots_ + i, slots_ + capacity_);
+  }
+
+  /**
+   * @tparam L The lookup key type.
+   * @param key The key to count.
+   * @return 1 if the key is in the map, otherwise 0.
+   */
+  template<typename L>
+  size_type count(const L &key) const { return FindSlot(key) == capacity_ ? 0 : 1; }
+
+  /**
+   * @brief Insert an entry if the key is not in the map yet.
+   * @param key The key.
+   * @param value The value.
+   * @return An iterator to the entry with the key and true if it was inserted.
+   */
+  std::pair<iterator, bool> emplace(K key, V value) {
+    std::size_t hash = Hashed(key);
+    size_type i = FindSlot(key, hash);
+    if (i != capacity_) return std::make_pair(iterator(slots_ + i, slots_ + capacity_), false);
+    i = InsertNew(std::move(key), std::move(value), hash);
+    return std::make_pair(iterator(slots_ + i, slots_ + capacity_), true);
+  }
+
+  /**
+   * @brief Insert an entry if the key is not in the map yet.
+   * @param entry The entry.
+   * @return An iterator to the entry with the key and true if it was inserted.
+   */
+  std::pair<iterator, bool> insert(value_type entry) { return emplace(std::move(entry.first), std::move(entry.second)); }
+
+  /**
+   * @brief Get the value for a key, inserting a default value if the key is not in the map.
+   * @param key The key.
+   * @return A reference to the value.
+   */
+  V &operator[](const K &key) { return emplace(key, V()).first->second; }
+
+  /**
+   * @brief Remove the entry with a key.
+   * @tparam L The lookup key type.
+   * @param key The key to remove.
+   * @return The number of entries removed.
+   */
+  template<typename L>
+  size_type erase(const L &key) {
+    size_type i = FindSlot(key);
+    if (i == capacity_) return 0;
+    EraseSlot(i);
+    return 1;
+  }
+
+  /**
+   * @brief Remove an entry. Other iterators are invalidated as later entries may move back.
+   * @param position The entry to remove.
+   */
+  void erase(const_iterator position) { EraseSlot(static_cast<size_type>(position.slot_ - slots_)); }
+  void erase(iterator position) { EraseSlot(static_cast<size_type>(position.slot_ - slots_)); }
+
+  /**
+   * @brief Remove all entries. The slot array is kept.
+   */
+  void clear() {
+    for (size_type i = 0; i < capacity_ && size_; i++) {
+      if (slots_[i].hash) {
+        slots_[i].entry().~value_type();
+        slots_[i].hash = 0;
+        size_--;
+      }
+    }
+    size_ = 0;
+  }
+
+  /**
+   * @brief Make room for a number of entries without growing.
+   * @param count The number of entries.
+   */
+  void reserve(size_type count) {
+    size_type capacity = capacity_ ? capacity_ : kMinCapacity;
+    while (count * 4 > capacity * 3) capacity *= 2;
+    if (capacity != capacity_) Rehash(capacity);
+  }
+
+ private:
+  static constexpr size_type kMinCapacity = 8; ///< The first slot array size.
+
+  /**
+   * @brief Hash a key, never returning the empty slot marker.
+   * @tparam L The key type.
+   * @param key The key.
+   * @return The hash.
+   */
+  template<typename L>
+  std::size_t Hashed(const L &key) const {
+    std::size_t hash = hash_(key);
+    return hash ? hash : 1;
+  }
+
+  template<typename L>
+  size_type FindSlot(const L &key) const { return capacity_ ? FindSlot(key, Hashed(key)) : capacity_; }
+
+  /**
+   * @brief Probe for a key.
+   * @tparam L The key type.
+   * @param key The key.
+   * @param hash The hash of the key.
+   * @return The slot of the key or capacity_ if it is not in the map.
+   */
+  template<typename L>
+  size_type FindSlot(const L &key, std::size_t hash) const {
+    if (!capacity_) return capacity_;
+    size_type mask = capacity_ - 1;
+    for (size_type i = hash & mask;; i = (i + 1) & mask) {
+      const Slot &slot = slots_[i];
+      if (slot.hash == 0) return capacity_;
+      if (slot.hash == hash && equal_(slot.entry().first, key)) return i;
+    }
+  }
+
+  /**
+   * @brief Insert an entry that is known not to be in the map.
+   * @return The slot of the entry.
+   */
+  size_type InsertNew(K &&key, V &&value, std::size_t hash) {
+    if ((size_ + 1) * 4 > capacity_ * 3) Rehash(capacity_ ? capacity_ * 2 : kMinCapacity);
+    size_type mask = capacity_ - 1;
+    size_type i = hash & mask;
+    while (slots_[i].hash) i = (i + 1) & mask;
+    new(&slots_[i].storage) value_type(std::move(key), std::move(value));
+    slots_[i].hash = hash;
+    size_++;
+    return i;
+  }
+
+  /**
+   * @brief Remove the entry in a slot and shift the following entries of the probe run back.
+   * @param i The slot.
+   */
+  void EraseSlot(size_type i) {
+    size_type mask = capacity_ - 1;
+    slots_[i].entry().~value_type();
+    slots_[i].hash = 0;
+    size_--;
+    for (size_type j = (i + 1) & mask; slots_[j].hash; j = (j + 1) & mask) {
+      size_type ideal = slots_[j].hash & mask;
+      if (((j - ideal) & mask) >= ((j - i) & mask)) {
+        new(&slots_[i].storage) value_type(std::move(slots_[j].entry()));
+        slots_[i].hash = slots_[j].hash;
+        slots_[j].entry().~value_type();
+        slots_[j].hash = 0;
+        i = j;
+      }
+    }
+  }
+
+  /**
+   * @brief Allocate an empty slot array.
+   * @param capacity The number of slots, a power of two.
+   */
+  void Allocate(size_type capacity) {
+    slots_ = new Slot[capacity];
+    capacity_ = capacity;
+  }
+
+  /**
+   * @brief Move all entries to a new slot array.
+   * @param capacity The number of slots, a power of two.
+   */
+  void Rehash(size_type capacity) {
+    Slot *old_slots = slots_;
+    size_type old_capacity = capacity_;
+    Allocate(capacity);
+    size_type mask = capacity_ - 1;
+    for (size_type i = 0; i < old_capacity; i++) {
+      if (old_slots[i].hash) {
+        size_type j = old_slots[i].hash & mask;
+        while (slots_[j].hash) j = (j + 1) & mask;
+        new(&slots_[j].storage) value_type(std::move(old_slots[i].entry()));
+        slots_[j].hash = old_slots[i].hash;
+        old_slots[i].entry().~value_type();
+      }
+    }
+    delete[] old_slots;
+  }
+};
+
+template<typename K, typename V, typename Hash, typename Equal>
+constexpr typename FlatHashMap<K, V, Hash, Equal>::size_type FlatHashMap<K, V, Hash, Equal>::kMinCapacity;
+
+#endif //OBJECT_PROPERTY_TREE_FLAT_HASH_MAP_H
@@ -0,0 +1,61 @@
+#ifndef OBJECT_PROPERTY_TREE_KEY_INTERN_TABLE_H
+#define OBJECT_PROPERTY_TREE_KEY_INTERN_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <boost/thread/shared_mutex.hpp>
+#include "node_key.h"
+
+/**
+ * @brief A thread-safe, append-only table of names. Each distinct name is given a small integer id that stays valid
+ * for the lifetime of the table.
+ */
+class KeyInternTable {
+  mutable boost::shared_mutex mutex_; ///< Guards the table, lookups take a shared lock.
+  std::deque<std::string> names_; ///< Names by id - 1. A deque so that references stay valid as it grows.
+  std::unordered_map<boost::string_view, std::uint32_t, NodeKeyHash> ids_; ///< Ids by name, viewing into names_.
+
+ public:
+  /**
+   * @brief Create an empty table.
+   */
+  KeyInternTable() = default;
+
+  KeyInternTable(const KeyInternTable &) = delete;
+  KeyInternTable &operator=(const KeyInternTable &) = delete;
+
+  /**
+   * @return The table used for the keys of atom property trees.
+   */
+  static KeyInternTable &Global();
+
+  /**
+   * @brief Get the atom for a name, adding the name if it is not in the table yet.
+   * @param name The name to intern.
+   * @return The atom for the name.
+   */
+  KeyAtom Intern(boost::string_view name);
+
+  /**
+   * @brief Get the atom for a name without adding it.
+   * @param name The name to look up.
+   * @return The atom for the name or an invalid atom if the name has not been interned.
+   */
+  KeyAtom Find(boost::string_view name) const;
+
+  /**
+   * @brief Get the name of an atom.
+   * @param atom The atom.
+   * @return The name or an empty string for an invalid atom.
+   */
+  const std::string &Name(KeyAtom atom) const;
+
+  /**
+   * @return The number of names in the table.
+   */
+  std::size_t size() const;
+};
+
+#endif //OBJECT_PROPERTY_TREE_KEY_INTERN_TABLE_H
@@ -0,0 +1,215 @@
+#ifndef OBJECT_PROPERTY_TREE_LEAF_COLUMN_H
+#define OBJECT_PROPERTY_TREE_LEAF_COLUMN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "type_id.h"
+
+/**
+ * @brief Check if a type can be kept in a column: the arithmetic types other than bool.
+ * @tparam V The type.
+ */
+template<typename V>
+struct IsLeafColumnType
+    : std::integral_constant<bool, std::is_arithmetic<V>::value && !std::is_same<V, bool>::value> {};
+
+/**
+ * @brief The type the values of a column are summed in, wide enough that the sum of a column of int does not overflow:
+ * 64-bit integers of the same signedness for integer types, at least double for floating point types.
+ * @tparam V The type of the values.
+ */
+template<typename V>
+struct ColumnSumType {
+  typedef typename std::conditional<std::is_floating_point<V>::value, typename std::common_type<V, double>::type,
+                                    typename std::conditional<std::is_signed<V>::value, std::int64_t,
+                                                              std::uint64_t>::type>::type type;
+};
+
+/**
+ * @brief Summary of the values of a column below a node, see LeafColumn::Summarize.
+ * @tparam V The type of the values.
+ */
+template<typename V>
+struct ColumnSummary {
+  std::size_t count = 0; ///< The number of values.
+  typename ColumnSumType<V>::type sum = 0; ///< The sum of the values, see ColumnSumType.
+  V min = V(); ///< The smallest value, V() if there are none.
+  V max = V(); ///< The largest value, V() if there are none.
+};
+
+/**
+ * @brief The part of a column that does not depend on the type of its values.
+ */
+class LeafColumnBase {
+ protected:
+  std::vector<std::uint32_t> free_; ///< Released slots, reused by the next Add.
+  std::mutex runs_mutex_; ///< Guards runs_ between readers.
+  std::map<std::string, std::vector<std::pair<std::uint32_t, std::uint32_t>>> runs_; ///< Cached runs by path.
+
+ public:
+  virtual ~LeafColumnBase() = default;
+
+  /**
+   * @return The type of the values.
+   */
+  virtual TypeId type() const = 0;
+
+  /**
+   * @brief Release a slot for reuse. Invalidates the cached runs.
+   * @param slot The slot.
+   */
+  void Release(std::uint32_t slot) {
+    free_.push_back(slot);
+    runs_.clear();
+  }
+};
+
+/**
+ * @brief A node's reference to its value in a column. Stored as the data of the node instead of the value.
+ */
+struct ColumnSlot {
+  LeafColumnBase *column; ///< The column.
+  std::uint32_t slot; ///< The index of the value in the column.
+};
+
+/**
+ * @brief Contiguous storage for leaf values of one primitive type. Nodes refer to their value by slot, so reading all
+ * the values below a node runs over packed arrays instead of visiting the nodes: the slots below a path are collected
+ * once, merged into runs of consecutive slots and cached until a leaf of the column is added or removed. Leaves created
+ * together get consecutive slots, so a subtree is usually a handful of runs.
+ *
+ * The column does not lock. The tree that owns it changes it under its write lock and reads it under its read lock;
+ * the cache of runs has a mutex of its own because readers fill it.
+ * @tparam V The type of the values.
+ */
+template<typename V>
+class LeafColumn : public LeafColumnBase {
+  static_assert(IsLeafColumnType<V>::value, "columns hold arithmetic types other than bool");
+
+  std::vector<V> values_; ///< The values by slot.
+
+ public:
+  /**
+   * @brief A run of consecutive slots [first, second).
+   */
+  typedef std::pair<std::uint32_t, std::uint32_t> Run;
+
+  TypeId type() const override { return TypeId::Of<V>(); }
+
+  /**
+   * @brief Store a new value. Invalidates the cached runs.
+   * @param value The value.
+   * @return The slot of the value.
+   */
+  std::uint32_t Add(const V &value) {
+    runs_.clear();
+    if (!free_.empty()) {
+      std::uint32_t slot = free_.back();
+      free_.pop_back();
+      values_[slot] = value;
+      return slot;
+    }
+    values_.push_back(value);
+    return static_cast<std::uint32_t>(values_.size() - 1);
+  }
+
+  /**
+   * @param slot A slot.
+   * @return The value in the slot.
+   */
+  V &at(std::uint32_t slot) { return values_[slot]; }
+
+  /**
+   * @return The number of slots, including released ones.
+   */
+  std::size_t size() const { return values_.size(); }
+
+  /**
+   * @brief Summarise the values below a path.
+   * @tparam F The type of the collector, called as collect(slots) to append the slots below the path.
+   * @param key The canonical path the runs are cached under.
+   * @param collect Collects the slots when the runs are not cached.
+   * @return The summary.
+   */
+  template<typename F>
+  ColumnSummary<V> Summarize(const std::string &key, F collect) {
+    const std::vector<Run> *runs;
+    {
+      std::lock_guard<std::mutex> l(runs_mutex_);
+      auto i = runs_.find(key);
+      if (i == runs_.end()) {
+        std::vector<std::uint32_t> slots;
+        collect(slots);
+        i = runs_.emplace(key, Merge(slots)).first;
+      }
+      // Entries are only erased by writers, which exclude the readers.
+      runs = &i->second;
+    }
+    ColumnSummary<V> summary;
+    if (runs->empty()) return summary;
+    summary.min = std::numeric_limits<V>::max();
+    summary.max = std::numeric_limits<V>::lowest();
+    for (auto &run : *runs) {
+      Accumulate(values_.data() + run.first, run.second - run.first, summary);
+    }
+    return summary;
+  }
+
+ private:
+  /**
+   * @brief Sort slots and merge them into runs.
+   * @param slots The slots.
+   * @return The runs.
+   */
+  static std::vector<Run> Merge(std::vector<std::uint32_t> &slots) {
+    std::sort(slots.begin(), slots.end());
+    std::vector<Run> runs;
+    for (auto slot : slots) {
+      if (!runs.empty() && runs.back().second == slot) {
+        runs.back().second++;
+      } else {
+        runs.emplace_back(slot, slot + 1);
+      }
+    }
+    return runs;
+  }
+
+  /**
+   * @brief Add a packed array of values to a summary. The loop keeps four independent lanes, so it does not wait on
+   * one accumulator and the compiler can map the lanes to vector registers.
+   * @param values The values.
+   * @param count The number of values.
+   * @param summary The summary to add to.
+   */
+  static void Accumulate(const V *values, std::size_t count, ColumnSummary<V> &summary) {
+    typename ColumnSumType<V>::type sum[4] = {0, 0, 0, 0};
+    V min[4] = {summary.min, summary.min, summary.min, summary.min};
+    V max[4] = {summary.max, summary.max, summary.max, summary.max};
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      for (int lane = 0; lane < 4; lane++) {
+        V value = values[i + lane];
+        sum[lane] += value;
+        min[lane] = value < min[lane] ? value : min[lane];
+        max[lane] = value > max[lane] ? value : max[lane];
+      }
+    }
+    for (; i < count; i++) {
+      sum[0] += values[i];
+      min[0] = values[i] < min[0] ? values[i] : min[0];
+      max[0] = values[i] > max[0] ? values[i] : max[0];
+    }
+    summary.count += count;
+    summary.sum += (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    summary.min = std::min(std::min(min[0], min[1]), std::min(min[2], min[3]));
+    summary.max = std::max(std::max(max[0], max[1]), std::max(max[2], max[3]));
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_LEAF_COLUMN_H
@@ -1,26 +1,37 @@
 #ifndef OBJECT_PROPERTY_TREE_NODE_H
 #define OBJECT_PROPERTY_TREE_NODE_H
 
-#include <map>
+#include <cstdint>
 #include <functional>
+#include <vector>
+#include "compiled_path.h"
+#include "node_allocator.h"
+#include "node_children.h"
 #include "node_path.h"
+#include "node_table.h"
+#include "path_tokenizer.h"
 
 /**
  * @brief This is a class for handling the leaf nodes of the property tree.
  * @tparam K The type of the node name.
  * @tparam T The type of the node data.
+ * @tparam C The children container policy, see node_children.h.
  */
-template<typename K, typename T>
+template<typename K, typename T, typename C = MapChildren>
 class Node {
  public:
-  typedef std::map<K, Node *> ChildMap; ///< map of children.
+  typedef typename C::template Container<K, Node *> ChildMap; ///< map of children, searchable by path segments.
   typedef NodePath<K> Path; ///< path in a tree.
 
  private:
   K name_; ///< The name of the node.
   T data_; ///< The leaf data.
+  std::uint32_t handle_slot_ = 0; ///< The slot of the node in a NodeTable, 0 if it has none. Packs after 4 byte data.
   Node *parent_ = nullptr; ///< The node's parent.
   ChildMap children_; ///< The children.
+  std::uint64_t version_ = 0; ///< The version of the last change to this node.
+  std::uint64_t subtree_version_ = 0; ///< The version of the last change to this node or a descendant.
+  NodeTable<Node> *handle_table_ = nullptr; ///< The table the node has a slot in, so destroying it frees the slot.
 
  public:
   /**
@@ -47,9 +58,11 @@ class Node {
   explicit Node(const K &name, Node *parent = nullptr) : name_(name), parent_(parent) {}
 
   /**
-   * @brief Destruct and de-register from parent.
+   * @brief Destruct and de-register from parent. The slot of the node in a NodeTable is freed, so its handles are
+   * stale however the node was removed.
    */
   virtual ~Node() {
+    if (handle_table_) handle_table_->Remove(this);
     if (parent_) {
       parent_->children_.erase(name()); // detach
       parent_ = nullptr;
@@ -87,36 +100,66 @@ class Node {
   void SetData(const T &data) { data_ = data; }
 
   /**
-   * @brief Get a pointer to a child with a given name.
+   * @brief Set the node data value by moving it.
+   * @param data The node data to set.
+   */
+  void SetData(T &&data) { data_ = std::move(data); }
+
+  /**
+   * @brief Get a pointer to a child with a given name. The child map is not modified.
    * @param child_name The browse name of child to find.
    * @return pointer to the child or nullptr.
    */
-  Node *GetChild(const K &child_name) { return children_[child_name]; }
+  Node *GetChild(const K &child_name) { return FindChild(child_name); }
+
+  /**
+   * @brief Look up a direct child without modifying the child map.
+   * @tparam S The segment type, anything comparable with K.
+   * @param segment The name of the child.
+   * @return pointer to the child or nullptr.
+   */
+  template<typename S>
+  Node *FindChild(const S &segment) {
+    auto i = children_.find(NodeKeyTraits<K>::Lookup(segment));
+    return i == children_.end() ? nullptr : i->second;
+  }
 
   /**
    * @brief Checks if this node has a child with the name given.
    * @param child_name The browse name of child to find.
    * @return true if child exists.
    */
-  bool HasChild(const K &child_name) {
-    if ( children_.find(child_name) == children_.end() ) {
-      return false;
-    } else {
-      return children_[child_name] != nullptr;
-    }
-  }
+  bool HasChild(const K &child_name) { return FindChild(child_name) != nullptr; }
 
   /**
-   * @brief Add a child to the node.
+   * @brief Add a child to the node. A child with the same name is destroyed with its descendants, which must have been
+   * created on the heap. Use the allocator overload for nodes of a tree.
    * @param child_node pointer to child node to add.
    */
   void AddChild(Node *child_node) {
-    if (HasChild(child_node->name())) {
-      delete children_[child_node->name()];
-      children_.erase(child_node->name());
+    HeapNodeAllocator<Node> allocator;
+    AddChild(child_node, allocator);
+  }
+
+  /**
+   * @brief Add a child to the node. A child with the same name is destroyed with its descendants.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param child_node pointer to child node to add.
+   * @param allocator The allocator the replaced child was created with.
+   */
+  template<typename A>
+  void AddChild(Node *child_node, A &allocator) {
+    auto result = children_.emplace(child_node->name(), child_node);
+    if (!result.second) {
+      Node *old_node = result.first->second;
+      result.first->second = child_node;
+      if (old_node && old_node != child_node) {
+        old_node->parent_ = nullptr;
+        old_node->DestroyChildren(allocator);
+        allocator.Destroy(old_node);
+      }
     }
-    children_[child_node->name()] = child_node;
-  };
+  }
 
   /**
    * @brief Creates a child with default data.
@@ -132,14 +175,132 @@ class Node {
   }
 
   /**
-   * @brief Remove a child with the name given.
+   * @brief Creates a child with default data using a node allocator.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param name The child's name.
+   * @param allocator The allocator to create the child with.
+   * @return Pointer to the created node.
+   */
+  template<typename A>
+  Node *CreateChild(const K &name, A &allocator) {
+    Node *node = allocator.Create(name, this);
+    AddChild(node, allocator);
+    return node;
+  }
+
+  /**
+   * @brief Destroy all children and their descendants with the allocator that created them.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param allocator The allocator the children were created with.
+   */
+  template<typename A>
+  void DestroyChildren(A &allocator) {
+    for (auto i = children_.begin(); i != children_.end(); i++) {
+      Node *node = i->second;
+      if (node) {
+        node->parent_ = nullptr;
+        node->DestroyChildren(allocator);
+        allocator.Destroy(node);
+      }
+    }
+    children_.clear();
+  }
+
+  /**
+   * @brief Detach this node from its parent and destroy it and its descendants with the allocator that created them.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param allocator The allocator the nodes were created with.
+   */
+  template<typename A>
+  void Destroy(A &allocator) {
+    if (parent_) {
+      parent_->children_.erase(name()); // detach
+      parent_ = nullptr;
+    }
+    DestroyChildren(allocator);
+    allocator.Destroy(this);
+  }
+
+  /**
+   * @brief Remove a child with the name given and destroy it with its descendants, which must have been created on the
+   * heap. Use the allocator overload for nodes of a tree.
    * @param child_name The name of the child to remove.
    */
   void RemoveChild(const K &child_name) {
-    if (HasChild(child_name)) {
-      Node *child_node = GetChild(child_name);  // take the child node
+    HeapNodeAllocator<Node> allocator;
+    RemoveChild(child_name, allocator);
+  }
+
+  /**
+   * @brief Remove a child with the name given and destroy it with its descendants.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param child_name The name of the child to remove.
+   * @param allocator The allocator the nodes were created with.
+   */
+  template<typename A>
+  void RemoveChild(const K &child_name, A &allocator) {
+    auto i = children_.find(child_name);
+    if (i != children_.end()) {
+      Node *child_node = i->second;  // take the child node
+      children_.erase(i);
+      if (child_node) {
+        child_node->parent_ = nullptr;
+        child_node->DestroyChildren(allocator);
+        allocator.Destroy(child_node);
+      }
+    }
+  }
+
+  /**
+   * @brief Purge null entries from the child maps of this node and its descendants. Lookups never add entries, but
+   * null children can be left behind by code that writes to children() directly.
+   * @return The number of entries purged.
+   */
+  std::size_t Compact() {
+    std::size_t purged = 0;
+    std::vector<K> null_children;
+    for (auto i = children_.begin(); i != children_.end(); i++) {
+      if (i->second) {
+        purged += i->second->Compact();
+      } else {
+        null_children.push_back(i->first);
+      }
+    }
+    for (auto &child_name : null_children) {
       children_.erase(child_name);
-      if (child_node) delete child_node;
+    }
+    return purged + null_children.size();
+  }
+
+  /**
+   * @brief Record a change to this node. The version is propagated to the subtree versions of the ancestors, up to the
+   * first ancestor that already has it.
+   * @param version The version of the change, it must not be older than any version in the tree.
+   */
+  void Stamp(std::uint64_t version) {
+    version_ = version;
+    for (Node *node = this; node && node->subtree_version_ != version; node = node->parent_) {
+      node->subtree_version_ = version;
+    }
+  }
+
+  /**
+   * @brief Visit the nodes of this subtree that changed after a version. Subtrees without such changes are skipped.
+   * @tparam F The visitor type, called with the path segments of the node relative to this node and the node.
+   * @param version The version to compare with.
+   * @param visitor The visitor.
+   * @param path The path of this node, the visitor sees it extended by the path of each visited node.
+   */
+  template<typename F>
+  void VisitChangedSince(std::uint64_t version, F &&visitor, Path &path) {
+    if (subtree_version_ <= version) return;
+    if (version_ > version) visitor(path, *this);
+    for (auto i = children_.begin(); i != children_.end(); i++) {
+      if (i->second && i->second->subtree_version_ > version) {
+        path.push_back(i->first);
+        i->second->VisitChangedSince(version, visitor, path);
+        path.pop_back();
+      }
     }
   }
 
@@ -166,6 +327,31 @@ class Node {
    */
   Node *parent() const { return parent_; }
 
+  /**
+   * @return The version of the last change to this node, see Stamp.
+   */
+  std::uint64_t version() const { return version_; }
+
+  /**
+   * @return The version of the last change to this node or one of its descendants.
+   */
+  std::uint64_t subtree_version() const { return subtree_version_; }
+
+  /**
+   * @return The slot of the node in a NodeTable, 0 if it has none.
+   */
+  std::uint32_t handle_slot() const { return handle_slot_; }
+
+  /**
+   * @brief Set the slot of the node in a NodeTable.
+   * @param table The table, nullptr for none.
+   * @param slot The slot, 0 for none.
+   */
+  void SetHandleSlot(NodeTable<Node> *table, std::uint32_t slot) {
+    handle_table_ = table;
+    handle_slot_ = slot;
+  }
+
   /**
    * @brief Set or replace the parent node.
    * @param parent_node A pointer to the parent node to set.
@@ -188,25 +374,74 @@ class Node {
    * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
    */
   Node *Find(const Path &path, int depth = 0) {
-    Node *res = GetChild(path[depth]);// do we have the child at this level?
-    if (res) {
-      depth++;
-      if (depth < (int) path.size()) {
-        res = res->Find(path, depth);
-      }
-    }
-    return res;
+    return FindRange(path.begin() + depth, path.end());
   }
 
   /**
    * @brief Get a pointer to the node at the path.
+   * @tparam S The type of the path segments.
+   * @param path The path to search in.
+   * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
+   */
+  template<typename S>
+  Node *Find(const PathSpan<S> &path) { return FindRange(path.begin(), path.end()); }
+
+  /**
+   * @brief Get a pointer to the node at the path.
+   * @param path The path to search in.
+   * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
+   */
+  Node *Find(const PathTokenizer &path) { return FindRange(path.begin(), path.end()); }
+
+  /**
+   * @brief Get a pointer to the node at the path. The path is split in place without allocating.
+   * @param path The path to search in.
+   * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
+   */
+  Node *Find(boost::string_view path) { return Find(PathTokenizer(path)); }
+
+  /**
+   * @brief Get a pointer to the node at a path that has already been parsed.
    * @param path The path to search in.
    * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
    */
-  Node *Find(const K &path) {
-    Path p;
-    p.ToList(path);
-    return Find(p);
+  Node *Find(const CompiledPath &path) { return FindRange(path.begin(), path.end()); }
+
+  /**
+   * @brief Find the nodes at several paths. The segments a path shares with the previous path are not walked again, so
+   * paths listed next to their siblings only pay for the segments where they differ.
+   * @tparam P Path type.
+   * @tparam F Visitor type, called as visitor(index, node) for each path in order, with nullptr for missing nodes.
+   * @param paths The paths with respect to this node.
+   * @param visitor The visitor.
+   */
+  template<typename P, typename F>
+  void FindEach(const std::vector<P> &paths, F visitor) {
+    std::vector<Node *> nodes{this}; // the nodes found along the previous path
+    for (std::size_t i = 0; i < paths.size(); i++) {
+      auto &&segments = PathSegments(paths[i]);
+      auto segment = segments.begin();
+      auto end = segments.end();
+      if (segment == end) {
+        visitor(i, static_cast<Node *>(nullptr));
+        continue;
+      }
+      std::size_t depth = 0;
+      if (i > 0) {
+        auto &&previous = PathSegments(paths[i - 1]);
+        for (auto shared = previous.begin(); shared != previous.end() && segment != end && depth + 1 < nodes.size()
+            && *shared == *segment; ++shared, ++segment) {
+          depth++;
+        }
+      }
+      nodes.resize(depth + 1);
+      Node *node = nodes.back();
+      for (; node && segment != end; ++segment) {
+        node = node->FindChild(*segment);
+        nodes.push_back(node);
+      }
+      visitor(i, node);
+    }
   }
 
   /**
@@ -214,55 +449,113 @@ class Node {
    * @param path The path with respect to this node.
    * @return A pointer to the new node or nullptr.
    */
-  Node *Add(const Path &path) {
-    Node *new_node = Find(path); // Only create if it does not exist.
-    if (!new_node) {
-      // Create the path as required.
-      new_node = this;
-      int depth = 0;
-      while (new_node->HasChild(path[depth])) {
-        new_node = new_node->GetChild(path[depth]);
-        depth++;
-      }
-      // Create the rest.
-      for (auto i = static_cast<unsigned int>(depth); i < path.size(); i++) {
-        new_node = new_node->CreateChild(path[i]);
-      }
-    }
+  Node *Add(const Path &path) { return FindOrEmplace(path); }
 
-    return new_node;
-  }
+  /**
+   * @brief Adds a node to the tree starting with this node.
+   * @tparam S The type of the path segments.
+   * @param path The path with respect to this node.
+   * @return A pointer to the new node or nullptr.
+   */
+  template<typename S>
+  Node *Add(const PathSpan<S> &path) { return FindOrEmplace(path); }
 
   /**
    * @brief Adds a node to the tree starting with this node.
    * @param path The path with respect to this node.
    * @return A pointer to the new node or nullptr.
    */
-  Node *Add(const K &path) {
-    Path p;
-    p.ToList(path);
-    return Add(p);
-  }
+  Node *Add(const PathTokenizer &path) { return FindOrEmplace(path); }
+
+  /**
+   * @brief Adds a node to the tree starting with this node.
+   * @param path The path with respect to this node.
+   * @return A pointer to the new node or nullptr.
+   */
+  Node *Add(boost::string_view path) { return Add(PathTokenizer(path)); }
 
   /**
-   * @brief Removes a node from the tree at path starting with this node.
+   * @brief Adds a node to the tree starting with this node.
    * @param path The path with respect to this node.
+   * @return A pointer to the new node or nullptr.
    */
-  void Remove(const Path &path) {
-    Node *node = Find(path);
-    if (node) {
-      delete node;
+  Node *Add(const CompiledPath &path) { return FindOrEmplace(path); }
+
+  /**
+   * @brief Adds a node to the tree starting with this node, creating missing nodes with an allocator.
+   * @tparam P Path type.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param path The path with respect to this node.
+   * @param allocator The allocator to create nodes with.
+   * @return A pointer to the new node or nullptr.
+   */
+  template<typename P, typename A>
+  Node *Add(const P &path, A &allocator) { return FindOrEmplace(path, allocator); }
+
+  /**
+   * @brief Get the node at a path, creating it and any missing ancestors. The path is walked once with a single child
+   * lookup per existing level, the missing levels are created without further lookups.
+   * @tparam P Path type.
+   * @tparam A The node allocator type, see node_allocator.h.
+   * @param path The path with respect to this node.
+   * @param allocator The allocator to create nodes with.
+   * @return A pointer to the node at the path or nullptr if the path is empty.
+   */
+  template<typename P, typename A>
+  Node *FindOrEmplace(const P &path, A &allocator) {
+    auto &&segments = PathSegments(path);
+    auto segment = segments.begin();
+    auto end = segments.end();
+    if (segment == end) return nullptr;
+    Node *node = this;
+    for (; segment != end; ++segment) {
+      Node *child = node->FindChild(*segment);
+      if (!child) break;
+      node = child;
+    }
+    for (; segment != end; ++segment) {
+      node = node->CreateChild(NodeKeyTraits<K>::Make(*segment), allocator);
     }
+    return node;
+  }
+
+  /**
+   * @brief Get the node at a path, creating it and any missing ancestors on the heap.
+   * @tparam P Path type.
+   * @param path The path with respect to this node.
+   * @return A pointer to the node at the path or nullptr if the path is empty.
+   */
+  template<typename P>
+  Node *FindOrEmplace(const P &path) {
+    HeapNodeAllocator<Node> allocator;
+    return FindOrEmplace(path, allocator);
+  }
+
+  /**
+   * @brief Removes a node and its descendants from the tree at path starting with this node. The nodes must have been
+   * created on the heap, use the allocator overload for nodes of a tree.
+   * @tparam P Path type.
+   * @param path The path with respect to this node.
+   */
+  template<typename P>
+  void Remove(const P &path) {
+    HeapNodeAllocator<Node> allocator;
+    Remove(path, allocator);
   }
 
   /**
-   * @brief Removes a node from the tree at path starting with this node.
+   * @brief Removes a node and its descendants from the tree at path starting with this node.
+   * @tparam P Path type.
+   * @tparam A The node allocator type, see node_allocator.h.
    * @param path The path with respect to this node.
+   * @param allocator The allocator the nodes were created with.
    */
-  void Remove(const K &path) {
-    Path node_path;
-    node_path.ToList(path);
-    Remove(node_path);
+  template<typename P, typename A>
+  void Remove(const P &path, A &allocator) {
+    Node *node = Find(path);
+    if (node) {
+      node->Destroy(allocator);
+    }
   }
 
   /**
@@ -293,5 +586,23 @@ class Node {
     }
   }
 
+ private:
+  /**
+   * @brief Walk a range of path segments from this node.
+   * @tparam I The segment iterator type.
+   * @param begin The first segment.
+   * @param end The end of the segments.
+   * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
+   */
+  template<typename I>
+  Node *FindRange(I begin, I end) {
+    if (begin == end) return nullptr;
+    Node *node = this;
+    for (; node && begin != end; ++begin) {
+      node = node->FindChild(*begin);
+    }
+    return node;
+  }
+
 };
 #endif //OBJECT_PROPERTY_TREE_NODE_H
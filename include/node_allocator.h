@@ -0,0 +1,220 @@
+#ifndef OBJECT_PROPERTY_TREE_NODE_ALLOCATOR_H
+#define OBJECT_PROPERTY_TREE_NODE_ALLOCATOR_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Allocates every node on its own with new and delete.
+ * @tparam N The node type.
+ */
+template<typename N>
+class HeapNodeAllocator {
+ public:
+  /**
+   * @brief Create a node.
+   * @tparam Args The node constructor argument types.
+   * @param args The node constructor arguments.
+   * @return The new node.
+   */
+  template<typename... Args>
+  N *Create(Args &&... args) { return new N(std::forward<Args>(args)...); }
+
+  /**
+   * @brief Destroy a node created by this allocator.
+   * @param node The node to destroy.
+   */
+  void Destroy(N *node) { delete node; }
+
+  /**
+   * @brief Release memory held for nodes that have been destroyed. Heap nodes are freed as they are destroyed.
+   */
+  void Release() {}
+};
+
+/**
+ * @brief Carves nodes out of slabs of NodesPerChunk nodes. Destroyed nodes go on a free list and are reused by the
+ * next Create, and Release frees the slabs themselves, so a whole tree is returned to the system a chunk at a time
+ * instead of a node at a time. Not thread-safe, the owning tree serialises access.
+ * @tparam N The node type.
+ * @tparam NodesPerChunk The number of nodes per slab.
+ */
+template<typename N, std::size_t NodesPerChunk = 256>
+class NodePool {
+  /**
+   * @brief Storage for one node, or the link to the next free slot.
+   */
+  union Slot {
+    Slot *next; ///< The next free slot.
+    typename std::aligned_storage<sizeof(N), alignof(N)>::type storage; ///< The node.
+  };
+
+  std::vector<Slot *> chunks_; ///< The slabs.
+  Slot *free_ = nullptr; ///< The free list of destroyed nodes.
+  std::size_t next_ = NodesPerChunk; ///< The next never used slot in the last slab.
+  std::size_t size_ = 0; ///< The number of live nodes.
+
+ public:
+  /**
+   * @brief Create an empty pool. The first slab is allocated by the first Create.
+   */
+  NodePool() = default;
+
+  NodePool(const NodePool &) = delete;
+  NodePool &operator=(const NodePool &) = delete;
+
+  /**
+   * @brief Free the slabs. All nodes must have been destroyed.
+   */
+  ~NodePool() { Release(); }
+
+  /**
+   * @brief Create a node.
+   * @tparam Args The node constructor argument types.
+   * @param args The node constructor arguments.
+   * @return The new node.
+   */
+  template<typename... Args>
+  N *Create(Args &&... args) {
+    Slot *slot = Allocate();
+    try {
+      N *node = new(&slot->storage) N(std::forward<Args>(args)...);
+      size_++;
+      return node;
+    } catch (...) {
+      Deallocate(slot);
+      throw;
+    }
+  }
+
+  /**
+   * @brief Destroy a node created by this pool and put its slot on the free list.
+   * @param node The node to destroy.
+   */
+  void Destroy(N *node) {
+    node->~N();
+    Deallocate(reinterpret_cast<Slot *>(node));
+    size_--;
+  }
+
+  /**
+   * @brief Free all slabs at once. All nodes must have been destroyed.
+   */
+  void Release() {
+    for (auto chunk : chunks_) {
+      delete[] chunk;
+    }
+    chunks_.clear();
+    free_ = nullptr;
+    next_ = NodesPerChunk;
+    size_ = 0;
+  }
+
+  /**
+   * @return The number of live nodes.
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @return The number of nodes the allocated slabs can hold.
+   */
+  std::size_t capacity() const { return chunks_.size() * NodesPerChunk; }
+
+ private:
+  /**
+   * @return A free slot, from the free list if possible.
+   */
+  Slot *Allocate() {
+    if (free_) {
+      Slot *slot = free_;
+      free_ = slot->next;
+      return slot;
+    }
+    if (next_ == NodesPerChunk) {
+      chunks_.push_back(new Slot[NodesPerChunk]);
+      next_ = 0;
+    }
+    return chunks_.back() + next_++;
+  }
+
+  /**
+   * @brief Put a slot on the free list.
+   * @param slot The slot.
+   */
+  void Deallocate(Slot *slot) {
+    slot->next = free_;
+    free_ = slot;
+  }
+};
+
+/**
+ * @brief Serialises Create and Destroy of another allocator, for trees whose nodes are created by several threads at
+ * once.
+ * @tparam Allocator The allocator type.
+ */
+template<typename Allocator>
+class SynchronizedAllocator {
+  Allocator allocator_; ///< The allocator.
+  std::mutex mutex_; ///< Serialises the allocator.
+
+ public:
+  /**
+   * @brief Create a node.
+   * @tparam Args The node constructor argument types.
+   * @param args The node constructor arguments.
+   * @return The new node.
+   */
+  template<typename... Args>
+  auto Create(Args &&... args) -> decltype(allocator_.Create(std::forward<Args>(args)...)) {
+    std::lock_guard<std::mutex> l(mutex_);
+    return allocator_.Create(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Destroy a node created by this allocator.
+   * @tparam N The node type.
+   * @param node The node to destroy.
+   */
+  template<typename N>
+  void Destroy(N *node) {
+    std::lock_guard<std::mutex> l(mutex_);
+    allocator_.Destroy(node);
+  }
+
+  /**
+   * @brief Release memory held for nodes that have been destroyed.
+   */
+  void Release() {
+    std::lock_guard<std::mutex> l(mutex_);
+    allocator_.Release();
+  }
+
+  /**
+   * @return The underlying allocator. Only safe to inspect while no other thread uses the allocator.
+   */
+  const Allocator &allocator() const { return allocator_; }
+};
+
+/**
+ * @brief Node allocation policy: nodes are allocated individually on the heap. This is the default.
+ */
+struct HeapAllocation {
+  template<typename N>
+  using Allocator = HeapNodeAllocator<N>;
+};
+
+/**
+ * @brief Node allocation policy: nodes are carved from per-tree slab pools, see NodePool.
+ * @tparam NodesPerChunk The number of nodes per slab.
+ */
+template<std::size_t NodesPerChunk = 256>
+struct PoolAllocation {
+  template<typename N>
+  using Allocator = NodePool<N, NodesPerChunk>;
+};
+
+#endif //OBJECT_PROPERTY_TREE_NODE_ALLOCATOR_H
@@ -0,0 +1,45 @@
+#ifndef OBJECT_PROPERTY_TREE_NODE_CHILDREN_H
+#define OBJECT_PROPERTY_TREE_NODE_CHILDREN_H
+
+#include <functional>
+#include <map>
+#include "flat_hash_map.h"
+#include "small_vector_map.h"
+
+/**
+ * @brief Children container policy: children are kept in a std::map ordered by name. This is the default.
+ */
+struct MapChildren {
+  static constexpr bool ordered = true; ///< Iteration visits the children ordered by name.
+
+  template<typename K, typename V>
+  using Container = std::map<K, V, std::less<>>;
+};
+
+/**
+ * @brief Children container policy: children are kept in an open addressing hash map. Lookups are O(1) and do not
+ * allocate per child, which suits nodes with very many children. Iteration order is unspecified.
+ */
+struct FlatHashChildren {
+  static constexpr bool ordered = false; ///< Iteration order is unspecified.
+
+  template<typename K, typename V>
+  using Container = FlatHashMap<K, V>;
+};
+
+/**
+ * @brief Children container policy: up to N children are kept in a small sorted array, more than N spill into a
+ * FlatHashMap. The array is allocated for the first child, so leaves only carry three words for their children, and
+ * nodes with few children make a single allocation for them and are searched with a short linear scan. Iteration is
+ * ordered until a node spills.
+ * @tparam N The number of children kept in the array.
+ */
+template<std::size_t N = 4>
+struct SmallVectorChildren {
+  static constexpr bool ordered = false; ///< Spilled nodes iterate in unspecified order.
+
+  template<typename K, typename V>
+  using Container = SmallVectorMap<K, V, N>;
+};
+
+#endif //OBJECT_PROPERTY_TREE_NODE_CHILDREN_H
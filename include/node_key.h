@@ -0,0 +1,166 @@
+#ifndef OBJECT_PROPERTY_TREE_NODE_KEY_H
+#define OBJECT_PROPERTY_TREE_NODE_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <boost/utility/string_view.hpp>
+
+/**
+ * @brief Describes how path segments are turned into node keys. Specialise this for key types that cannot be
+ * constructed directly from a segment.
+ * @tparam K The type of the node name.
+ */
+template<typename K>
+struct NodeKeyTraits {
+  /**
+   * @brief Create a key from a path segment.
+   * @tparam S The segment type.
+   * @param segment The path segment.
+   * @return The key.
+   */
+  template<typename S>
+  static K Make(const S &segment) { return K(segment); }
+
+  /**
+   * @brief Convert a path segment into something the child map can search for.
+   * @tparam S The segment type.
+   * @param segment The path segment.
+   * @return The segment, by default child maps search for segments directly.
+   */
+  template<typename S>
+  static const S &Lookup(const S &segment) { return segment; }
+};
+
+/**
+ * @brief String keys are created from string views without going through a temporary.
+ */
+template<>
+struct NodeKeyTraits<std::string> {
+  static std::string Make(const std::string &segment) { return segment; }
+  static std::string Make(boost::string_view segment) { return std::string(segment.data(), segment.size()); }
+  static std::string Make(const char *segment) { return std::string(segment); }
+
+  template<typename S>
+  static const S &Lookup(const S &segment) { return segment; }
+};
+
+/**
+ * @brief An interned node name. Atoms of the same table compare equal if and only if their names are equal, so
+ * comparing two names is an integer comparison.
+ */
+struct KeyAtom {
+  std::uint32_t id = 0; ///< The id in the intern table. Zero is never assigned to a name.
+
+  /**
+   * @brief Create an invalid atom.
+   */
+  KeyAtom() = default;
+
+  /**
+   * @brief Create an atom from an id.
+   * @param atom_id The id in the intern table.
+   */
+  explicit KeyAtom(std::uint32_t atom_id) : id(atom_id) {}
+
+  /**
+   * @return true if the atom refers to a name.
+   */
+  explicit operator bool() const { return id != 0; }
+
+  /**
+   * @return The name of the atom in the global intern table.
+   */
+  const std::string &str() const;
+
+  bool operator==(const KeyAtom &other) const { return id == other.id; }
+  bool operator!=(const KeyAtom &other) const { return id != other.id; }
+  bool operator<(const KeyAtom &other) const { return id < other.id; }
+};
+
+/**
+ * @brief Print the name of an atom.
+ * @param output_stream The stream to print to.
+ * @param atom The atom to print.
+ * @return The stream.
+ */
+std::ostream &operator<<(std::ostream &output_stream, const KeyAtom &atom);
+
+namespace std {
+/**
+ * @brief Atoms hash by id.
+ */
+template<>
+struct hash<KeyAtom> {
+  std::size_t operator()(const KeyAtom &atom) const { return std::hash<std::uint32_t>()(atom.id); }
+};
+}
+
+struct CompiledSegment;
+
+/**
+ * @brief Atom keys are interned in the global KeyInternTable when nodes are created. Lookups never add names, so a path
+ * with an unknown segment simply does not match.
+ */
+template<>
+struct NodeKeyTraits<KeyAtom> {
+  static KeyAtom Make(const KeyAtom &segment) { return segment; }
+  static KeyAtom Make(boost::string_view segment);
+  static KeyAtom Make(const char *segment) { return Make(boost::string_view(segment)); }
+  static KeyAtom Make(const CompiledSegment &segment);
+
+  static const KeyAtom &Lookup(const KeyAtom &segment) { return segment; }
+  static KeyAtom Lookup(boost::string_view segment);
+  static KeyAtom Lookup(const char *segment) { return Lookup(boost::string_view(segment)); }
+  static KeyAtom Lookup(const CompiledSegment &segment);
+};
+
+/**
+ * @brief Hashes node keys and path segments. Strings and string views of the same characters hash equally, so a hash
+ * can be computed once when a path is parsed and reused for every lookup.
+ */
+struct NodeKeyHash {
+  /**
+   * @brief FNV-1a over the characters of a segment.
+   * @param segment The segment to hash.
+   * @return The hash.
+   */
+  std::size_t operator()(boost::string_view segment) const {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : segment) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+    return static_cast<std::size_t>(hash);
+  }
+
+  std::size_t operator()(const std::string &key) const { return (*this)(boost::string_view(key)); }
+  std::size_t operator()(const char *key) const { return (*this)(boost::string_view(key)); }
+
+  /**
+   * @param segment A compiled path segment.
+   * @return The hash computed when the path was compiled.
+   */
+  std::size_t operator()(const CompiledSegment &segment) const;
+
+  /**
+   * @brief Other key types use std::hash.
+   * @tparam Key The key type.
+   * @param key The key to hash.
+   * @return The hash.
+   */
+  template<typename Key>
+  std::size_t operator()(const Key &key) const { return std::hash<Key>()(key); }
+};
+
+/**
+ * @brief Compares node keys with keys or path segments of any comparable type.
+ */
+struct NodeKeyEqual {
+  template<typename A, typename B>
+  bool operator()(const A &a, const B &b) const { return a == b; }
+};
+
+#endif //OBJECT_PROPERTY_TREE_NODE_KEY_H
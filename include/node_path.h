@@ -2,12 +2,8 @@
 #define OBJECT_PROPERTY_TREE_NODE_PATH_H
 
 #include <vector>
-#include <boost/tokenizer.hpp>
-
-constexpr const char *DEFAULT_SEPARATOR = ".";
-
-// A tree is an addressable set of nodes. objects of type T must have an assignment operator.
-typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
+#include "node_key.h"
+#include "path_tokenizer.h"
 
 /**
  * @brief This class handles a path to a node in the property tree. The path is a vector list of any type.
@@ -33,11 +29,9 @@ class NodePath : public std::vector<T> {
    * @param string String to split.
    * @param separator The separator between fields.
    */
-  void ToList(const T &string, const char *separator = DEFAULT_SEPARATOR) {
-    boost::char_separator<char> sep(separator);
-    tokenizer tokens(string, sep);
-    for (auto i = tokens.begin(); i != tokens.end(); i++) {
-      this->push_back(*i);
+  void ToList(boost::string_view string, const char *separator = DEFAULT_SEPARATOR) {
+    for (auto segment : PathTokenizer(string, separator)) {
+      this->push_back(NodeKeyTraits<T>::Make(segment));
     }
   }
 
@@ -68,4 +62,13 @@ class NodePath : public std::vector<T> {
     return *this;
   }
 };
+
+/**
+ * @brief Get the segments of a path, see path_tokenizer.h.
+ * @param path A path.
+ * @return The path.
+ */
+template<typename T>
+inline const NodePath<T> &PathSegments(const NodePath<T> &path) { return path; }
+
 #endif //OBJECT_PROPERTY_TREE_NODE_PATH_H
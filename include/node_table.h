@@ -0,0 +1,123 @@
+#ifndef OBJECT_PROPERTY_TREE_NODE_TABLE_H
+#define OBJECT_PROPERTY_TREE_NODE_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A stable reference to a node: the slot of the node in a NodeTable and the generation of the slot. A handle
+ * stays valid until its node is removed, then it is stale and resolves to nothing, even if the slot is reused.
+ */
+struct NodeHandle {
+  std::uint32_t slot = 0; ///< The slot in the table, 0 for no node.
+  std::uint32_t generation = 0; ///< The generation of the slot when the handle was made.
+
+  /**
+   * @return true if the handle was made for a node. It may be stale since.
+   */
+  explicit operator bool() const { return slot != 0; }
+
+  bool operator==(const NodeHandle &other) const { return slot == other.slot && generation == other.generation; }
+  bool operator!=(const NodeHandle &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Maps handles to nodes. A node gets a slot when a handle to it is first made and keeps it until it is removed;
+ * then the generation of the slot goes up, which makes the handles to it stale, and the slot is reused. Resolving a
+ * handle is an index and a compare. Nodes free their slot when they are destroyed, however they are removed, so the
+ * table must outlive the nodes it has slots for. The table does not lock, the tree guards it with its own lock.
+ *
+ * Every node pays for this whether or not a handle is made to it: a 4 byte slot and a pointer to the table, 16 bytes
+ * with padding, or 8 bytes when the slot packs after 4 byte data such as int.
+ * @tparam N The node type. It must provide handle_slot() and SetHandleSlot(), and call Remove when it is destroyed.
+ */
+template<typename N>
+class NodeTable {
+  /**
+   * @brief A slot of the table.
+   */
+  struct Entry {
+    N *node; ///< The node, nullptr if the slot is free.
+    std::uint32_t generation; ///< Goes up each time the slot is freed.
+  };
+
+  std::vector<Entry> entries_{Entry{nullptr, 0}}; ///< The slots, slot 0 is never used.
+  std::vector<std::uint32_t> free_; ///< The free slots.
+
+ public:
+  /**
+   * @return true if no node has a slot.
+   */
+  bool empty() const { return free_.size() + 1 == entries_.size(); }
+
+  /**
+   * @brief Get the handle of a node, giving it a slot if it has none.
+   * @param node The node.
+   * @return The handle.
+   */
+  NodeHandle Add(N *node) {
+    std::uint32_t slot = node->handle_slot();
+    if (!slot) {
+      if (free_.empty()) {
+        slot = static_cast<std::uint32_t>(entries_.size());
+        entries_.push_back(Entry{node, 1});
+      } else {
+        slot = free_.back();
+        free_.pop_back();
+        entries_[slot].node = node;
+      }
+      node->SetHandleSlot(this, slot);
+    }
+    return NodeHandle{slot, entries_[slot].generation};
+  }
+
+  /**
+   * @brief Get the handle of a node that has a slot.
+   * @param node The node.
+   * @return The handle, or an empty handle if the node has no slot.
+   */
+  NodeHandle Handle(const N *node) const {
+    std::uint32_t slot = node->handle_slot();
+    return slot ? NodeHandle{slot, entries_[slot].generation} : NodeHandle();
+  }
+
+  /**
+   * @brief Resolve a handle.
+   * @param handle The handle.
+   * @return The node, or nullptr if the handle is empty or stale.
+   */
+  N *Get(const NodeHandle &handle) const {
+    if (handle.slot == 0 || handle.slot >= entries_.size()) return nullptr;
+    const Entry &entry = entries_[handle.slot];
+    return entry.generation == handle.generation ? entry.node : nullptr;
+  }
+
+  /**
+   * @brief Free the slot of a node that is being removed, making its handles stale. Nodes call this when they are
+   * destroyed.
+   * @param node The node.
+   */
+  void Remove(N *node) {
+    std::uint32_t slot = node->handle_slot();
+    if (!slot) return;
+    Entry &entry = entries_[slot];
+    entry.node = nullptr;
+    entry.generation++;
+    free_.push_back(slot);
+    node->SetHandleSlot(nullptr, 0);
+  }
+
+  /**
+   * @brief Free the slots of a node and its descendants.
+   * @param node The node.
+   */
+  void RemoveSubtree(N *node) {
+    if (empty()) return;
+    Remove(node);
+    for (auto &child : node->children()) {
+      if (child.second) RemoveSubtree(child.second);
+    }
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_NODE_TABLE_H
@@ -1,9 +1,13 @@
 #ifndef OBJECT_PROPERTY_TREE_OBJECT_PROPERTY_TREE_H
 #define OBJECT_PROPERTY_TREE_OBJECT_PROPERTY_TREE_H
 
+#include "atomic_leaf.h"
+#include "leaf_column.h"
+#include "object_value.h"
+#include "pointer_pool.h"
 #include "property_tree.h"
-#include <boost/any.hpp>
 #include <iostream>
+#include <memory>
 
 /**
  * @brief Parsed path to object.
@@ -11,14 +15,28 @@
 typedef NodePath<std::string> ObjectPath;
 
 /**
- * @brief Stores generic objects as boost any.
+ * @brief Stores generic objects as object values.
  */
-typedef PropertyTree<std::string, boost::any>::PropertyNode ObjectNode;
+typedef PropertyTree<std::string, ObjectValue>::PropertyNode ObjectNode;
 
 /**
- * @brief A property tree capable of storing any object types and pointers.
+ * @brief A property tree capable of storing any object types and pointers. Lookups by path read the object under the
+ * read lock; the node overloads leave locking to the caller.
+ *
+ * Leaves of a primitive type can be kept in a column, see RegisterColumn, so they can be summarised over a subtree
+ * without visiting the nodes. Counters and gauges can be held in atomic leaves, see GetAtomic, and updated without the
+ * tree lock. Such leaves are set with SetObject, which converts numbers to the type of an atomic leaf and refuses
+ * other objects for it. SetData replaces the column slot or the atomic with the data it is given. GetData copies the
+ * values of column leaves out of their column.
+ *
+ * Pointers are stored as std::shared_ptr, or as plain pointers when the tree does not own the object. Shared pointers
+ * are kept inline in the node, so storing an existing one does not allocate, and EmplacePointer makes the object and
+ * its control block in one block from a pool of the tree.
  */
-class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
+class ObjectPropertyTree : public PropertyTree<std::string, ObjectValue> {
+  std::vector<std::unique_ptr<LeafColumnBase>> columns_; ///< The registered columns, changed under the write lock.
+  std::vector<void (*)(LeafColumnBase *, std::uint32_t, ObjectValue &)> loaders_; ///< Copy a value out of a column.
+  PointerPool::Owner pointer_pool_ = PointerPool::Create(); ///< Memory for EmplacePointer.
 
  public:
   /**
@@ -26,6 +44,12 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    */
   ObjectPropertyTree() = default;
 
+  /**
+   * @brief Delete the object tree. The subscriptions are stopped before the columns and the pointer pool go, as a
+   * running callback may still read the tree.
+   */
+  ~ObjectPropertyTree() override { subscriptions().Stop(); }
+
   /**
    * @brief Set an object pointer at a path.
    * @tparam T The type of the pointer to set.
@@ -34,9 +58,7 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    */
   template<typename T>
   void SetPointer(const ObjectPath &path, T *object_pointer) {
-    std::string object_path;
-    path.ToString(object_path);
-    SetPointer(object_path, object_pointer);
+    SetData(path, std::shared_ptr<T>(object_pointer));
   }
 
   /**
@@ -47,30 +69,147 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    */
   template<typename T>
   void SetPointer(const std::string &path, T *object_pointer) {
-    auto shared_pointer = std::shared_ptr<T>(object_pointer);
-    SetData(path, shared_pointer);
+    SetData(path, std::shared_ptr<T>(object_pointer));
+  }
+
+  /**
+   * @brief Set an object pointer at a compiled path.
+   * @tparam T The type of the pointer to set.
+   * @param path The path where the pointer should be set.
+   * @param object_pointer The pointer to set.
+   */
+  template<typename T>
+  void SetPointer(const CompiledPath &path, T *object_pointer) {
+    SetData(path, std::shared_ptr<T>(object_pointer));
+  }
+
+  /**
+   * @brief Set a shared pointer at a path. The pointer is moved into the node as it is, so the object keeps its
+   * control block and nothing is allocated beyond the path.
+   * @tparam P Path type, or NodeHandle.
+   * @tparam T The type of the object.
+   * @param path The path where the pointer should be set.
+   * @param object_pointer The pointer to set.
+   */
+  template<typename P, typename T>
+  void SetPointer(const P &path, std::shared_ptr<T> object_pointer) {
+    Store(path, std::move(object_pointer));
+  }
+
+  /**
+   * @brief Set a pointer to an object the tree does not own at a path. The object is not deleted with the node and must
+   * outlive it. GetPointer returns it like an owned pointer.
+   * @tparam P Path type, or NodeHandle.
+   * @tparam T The type of the object.
+   * @param path The path where the pointer should be set.
+   * @param object_pointer The pointer to set.
+   */
+  template<typename P, typename T>
+  void SetUnownedPointer(const P &path, T *object_pointer) {
+    Store(path, object_pointer);
   }
 
   /**
-   * @brief Set and object at a path
+   * @brief Construct an object behind a shared pointer at a path. The object and its control block are made in one
+   * block from the pointer pool of the tree, with std::allocate_shared, and the block is reused once the last pointer
+   * is gone. The pool lives as long as any pointer made from it, also after the tree is destroyed.
+   * @tparam T The type of the object, not over-aligned, see PoolAllocator.
+   * @tparam P Path type, or NodeHandle.
+   * @tparam A The types of the constructor arguments.
+   * @param path The path where the pointer should be set.
+   * @param arguments The constructor arguments.
+   * @return false if the path is empty or the handle is stale.
+   */
+  template<typename T, typename P, typename... A>
+  bool EmplacePointer(const P &path, A &&... arguments) {
+    return Store(path, std::allocate_shared<T>(PoolAllocator<T>(pointer_pool_.get()), std::forward<A>(arguments)...));
+  }
+
+  /**
+   * @return The pool of EmplacePointer.
+   */
+  PointerPool &pointer_pool() { return *pointer_pool_; }
+
+  /**
+   * @brief Set and object at a path. An rvalue object is moved into the node instead of copied.
    * @tparam T The type of the object.
    * @param path The path to store the object.
    * @param object The object.
+   * @return false if the path is empty or the leaf is atomic and the object is not a number.
    */
   template<typename T>
-  void SetObject(std::string path, const T &object) {
-    SetData(path, object);
+  bool SetObject(const std::string &path, T &&object) {
+    return Store(path, std::forward<T>(object));
   }
 
   /**
-   * @brief Set and object at a path
+   * @brief Set and object at a path. An rvalue object is moved into the node instead of copied.
    * @tparam T The type of the object.
    * @param path The path to store the object.
    * @param object The object.
+   * @return false if the path is empty or the leaf is atomic and the object is not a number.
    */
   template<typename T>
-  void SetObject(ObjectPath path, const T &object) {
-    SetData(path, object);
+  bool SetObject(const ObjectPath &path, T &&object) {
+    return Store(path, std::forward<T>(object));
+  }
+
+  /**
+   * @brief Set and object at a compiled path. An rvalue object is moved into the node instead of copied.
+   * @tparam T The type of the object.
+   * @param path The path to store the object.
+   * @param object The object.
+   * @return false if the path is empty or the leaf is atomic and the object is not a number.
+   */
+  template<typename T>
+  bool SetObject(const CompiledPath &path, T &&object) {
+    return Store(path, std::forward<T>(object));
+  }
+
+  /**
+   * @brief Set an object at the node of a handle. An rvalue object is moved into the node instead of copied.
+   * @tparam T The type of the object.
+   * @param handle The handle, see Resolve.
+   * @param object The object.
+   * @return false if the handle is stale or the leaf is atomic and the object is not a number.
+   */
+  template<typename T>
+  bool SetObject(const NodeHandle &handle, T &&object) {
+    return Store(handle, std::forward<T>(object));
+  }
+
+  /**
+   * @brief Set an object at a path relative to the node of a handle, creating the path if necessary.
+   * @tparam P Path type.
+   * @tparam T The type of the object.
+   * @param base The handle the path is relative to, see Resolve.
+   * @param path The path below the base.
+   * @param object The object, moved if it is an rvalue.
+   * @return false if the base is stale, the path is empty or the leaf is atomic and the object is not a number.
+   */
+  template<typename P, typename T>
+  bool SetObject(const NodeHandle &base, const P &path, T &&object) {
+    bool stored = false;
+    auto setter = Setter(std::forward<T>(object));
+    return Update(base, path, [&setter, &stored](ObjectNode &node) { stored = setter(node); }) && stored;
+  }
+
+  /**
+   * @brief Construct an object in the storage of the node at a path, creating the path if necessary. The object is
+   * neither copied nor moved, unless it belongs in an atomic leaf or a column.
+   * @tparam T The type of the object.
+   * @tparam P Path type.
+   * @tparam A The types of the constructor arguments.
+   * @param path The path or handle of the node.
+   * @param arguments The constructor arguments.
+   * @return false if the path is empty, the handle is stale or the leaf is atomic and T is not a number.
+   */
+  template<typename T, typename P, typename... A>
+  bool Emplace(const P &path, A &&... arguments) {
+    bool stored = false;
+    return Update(path, [this, &stored, &arguments...](ObjectNode &node) {
+      stored = EmplaceIn<T>(node, std::forward<A>(arguments)...);
+    }) && stored;
   }
 
   /**
@@ -81,17 +220,11 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    */
   template<typename T>
   T *GetPointer(ObjectNode *object_node) {
-    if(object_node) {
-      try {
-        boost::any &object_data = object_node->data();
-        if (!object_data.empty() && object_data.type().hash_code() == typeid(std::shared_ptr<T>).hash_code()) {
-          std::shared_ptr<T> *object_pointer = boost::any_cast<std::shared_ptr<T> >(&object_data);
-          return object_pointer->get();
-        }
-      }
-      catch (...) {
-
-      }
+    if (object_node) {
+      std::shared_ptr<T> *object_pointer = object_node->data().template get<std::shared_ptr<T>>();
+      if (object_pointer) return object_pointer->get();
+      T **unowned_pointer = object_node->data().template get<T *>();
+      if (unowned_pointer) return *unowned_pointer;
     }
     return nullptr;
   }
@@ -104,11 +237,8 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    */
   template<typename T>
   T *GetPointer(const std::string &path) {
-    ObjectNode *node = Find(path);
-    if(node) {
-      return GetPointer<T>(node);
-    }
-    return nullptr;
+    ReadLock l(mutex());
+    return GetPointer<T>(GetRootNode().Find(path));
   }
 
   /**
@@ -119,9 +249,61 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    */
   template<typename T>
   T *GetPointer(const ObjectPath &path) {
-    std::string object_path;
-    path.ToString(object_path);
-    return GetPointer<T>(object_path);
+    ReadLock l(mutex());
+    return GetPointer<T>(GetRootNode().Find(path));
+  }
+
+  /**
+   * @brief Get the pointer of the object stored in the object tree at a compiled path.
+   * @tparam T The type of the stored object.
+   * @param path The path to the object node containing the object in question.
+   * @return A pointer to the object stored in the node.
+   */
+  template<typename T>
+  T *GetPointer(const CompiledPath &path) {
+    ReadLock l(mutex());
+    return GetPointer<T>(GetRootNode().Find(path));
+  }
+
+  /**
+   * @brief Get the pointer of the object stored at the node of a handle.
+   * @tparam T The type of the stored object.
+   * @param handle The handle, see Resolve.
+   * @return A pointer to the object, nullptr if there is none or the handle is stale.
+   */
+  template<typename T>
+  T *GetPointer(const NodeHandle &handle) {
+    ReadLock l(mutex());
+    return GetPointer<T>(GetHandleNode(handle));
+  }
+
+  /**
+   * @brief Get the pointer of the object stored at a path relative to the node of a handle.
+   * @tparam T The type of the stored object.
+   * @tparam P Path type.
+   * @param base The handle the path is relative to, see Resolve.
+   * @param path The path below the base.
+   * @return A pointer to the object, nullptr if there is none or the base is stale.
+   */
+  template<typename T, typename P>
+  T *GetPointer(const NodeHandle &base, const P &path) {
+    ReadLock l(mutex());
+    return GetPointer<T>(FindBelow(base, path));
+  }
+
+  /**
+   * @brief Get the object stored in the object node. If there is none, a new object for the specified type is returned.
+   * @tparam T The type of the object to get.
+   * @param object_node The object node containing the object in question.
+   * @return The object.
+   */
+  template<typename T>
+  T GetObject(ObjectNode *object_node) {
+    T *object = Lookup<T>(object_node);
+    if (object) return *object;
+    T atomic_object = T();
+    LoadAtomic(object_node, atomic_object);
+    return atomic_object;
   }
 
   /**
@@ -132,14 +314,8 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    */
   template<typename T>
   T GetObject(const std::string &path) {
-    ObjectNode *node = Find(path);
-    if (node) {
-      boost::any &object = node->data();
-      if (!object.empty() && object.type().hash_code() == typeid(T).hash_code()) {
-        return boost::any_cast<T>(object);
-      }
-    }
-    return new T();
+    ReadLock l(mutex());
+    return GetObject<T>(GetRootNode().Find(path));
   }
 
   /**
@@ -149,10 +325,225 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    * @return The object.
    */
   template<typename T>
-  T GetObject(ObjectPath &path) {
-    std::string path_string;
-    path.ToString(path_string);
-    return GetObject<T>(path_string);
+  T GetObject(const ObjectPath &path) {
+    ReadLock l(mutex());
+    return GetObject<T>(GetRootNode().Find(path));
+  }
+
+  /**
+   * @brief Get the object at a compiled path.
+   * @tparam T The type of the object to get.
+   * @param path The path of the object in the tree.
+   * @return The object.
+   */
+  template<typename T>
+  T GetObject(const CompiledPath &path) {
+    ReadLock l(mutex());
+    return GetObject<T>(GetRootNode().Find(path));
+  }
+
+  /**
+   * @brief Get the object at the node of a handle, without walking a path.
+   * @tparam T The type of the object to get.
+   * @param handle The handle, see Resolve.
+   * @return The object, a new object if there is none or the handle is stale.
+   */
+  template<typename T>
+  T GetObject(const NodeHandle &handle) {
+    ReadLock l(mutex());
+    return GetObject<T>(GetHandleNode(handle));
+  }
+
+  /**
+   * @brief Get the object at a path relative to the node of a handle. Only the path below the base is walked.
+   * @tparam T The type of the object to get.
+   * @tparam P Path type.
+   * @param base The handle the path is relative to, see Resolve.
+   * @param path The path below the base.
+   * @return The object, a new object if there is none or the base is stale.
+   */
+  template<typename T, typename P>
+  T GetObject(const NodeHandle &base, const P &path) {
+    ReadLock l(mutex());
+    return GetObject<T>(FindBelow(base, path));
+  }
+
+  /**
+   * @brief Get the objects at several paths under one read lock, so they are consistent with each other. Paths that
+   * share a prefix with the path before them continue from there. Use GetData with a list of ObjectValue to read
+   * objects of different types at once.
+   * @tparam T The type of the objects to get.
+   * @tparam P Path type.
+   * @param paths The paths of the objects.
+   * @param objects Receives the object for each path, a new object where there is none of the type.
+   * @return The number of paths where an object of the type exists.
+   */
+  template<typename T, typename P>
+  std::size_t GetObjects(const std::vector<P> &paths, std::vector<T> &objects) {
+    objects.clear();
+    objects.reserve(paths.size());
+    std::size_t found = 0;
+    ReadLock l(mutex());
+    GetRootNode().FindEach(paths, [&objects, &found](std::size_t, ObjectNode *node) {
+      T *object = Lookup<T>(node);
+      if (object) {
+        objects.push_back(*object);
+        found++;
+      } else {
+        objects.emplace_back();
+        if (LoadAtomic(node, objects.back())) found++;
+      }
+    });
+    return found;
+  }
+
+  /**
+   * @brief Get the objects at several paths below a common prefix under one read lock. The prefix is walked once.
+   * @tparam T The type of the objects to get.
+   * @tparam P Path type of the prefix.
+   * @tparam L Path type of the leaves.
+   * @param prefix The path of the node the leaves are relative to, e.g. "session.42".
+   * @param leaves The paths of the objects relative to the prefix.
+   * @param objects Receives the object for each leaf, a new object where there is none of the type.
+   * @return The number of leaves where an object of the type exists.
+   */
+  template<typename T, typename P, typename L>
+  std::size_t GetObjects(const P &prefix, const std::vector<L> &leaves, std::vector<T> &objects) {
+    objects.clear();
+    objects.reserve(leaves.size());
+    std::size_t found = 0;
+    ReadLock l(mutex());
+    auto node = GetRootNode().Find(prefix);
+    if (node) {
+      node->FindEach(leaves, [&objects, &found](std::size_t, ObjectNode *leaf) {
+        T *object = Lookup<T>(leaf);
+        if (object) {
+          objects.push_back(*object);
+          found++;
+        } else {
+          objects.emplace_back();
+          if (LoadAtomic(leaf, objects.back())) found++;
+        }
+      });
+    } else {
+      objects.resize(leaves.size());
+    }
+    return found;
+  }
+
+  /**
+   * @brief Read the object at a path in place under the read lock, without copying it. The reader must not keep the
+   * reference and must not call into the tree at all, not even to read: taking the read lock again deadlocks once a
+   * writer is waiting for the lock. To read other nodes, it can use the node overloads, e.g. GetObject(ObjectNode *)
+   * on GetRootNode().Find(path), which leave locking to the caller. An atomic leaf is read as a snapshot of its value.
+   * @tparam T The type of the object.
+   * @tparam P Path type, or NodeHandle.
+   * @tparam F The type of the reader, called as reader(const T &).
+   * @param path The path or handle of the object.
+   * @param reader The reader.
+   * @return true if an object of the type exists and the reader was called.
+   */
+  template<typename T, typename P, typename F>
+  bool Read(const P &path, F reader) {
+    ReadLock l(mutex());
+    ObjectNode *node = Locate(path);
+    const T *object = Lookup<T>(node);
+    if (object) {
+      reader(*object);
+      return true;
+    }
+    return ReadAtomic<T>(node, reader);
+  }
+
+  /**
+   * @brief Change the object at a path in place under the write lock, without copying it. The node is stamped with a
+   * new generation and the change is published, as with SetObject. The modifier must not call back into the tree.
+   * Atomic leaves are not changed, use their AtomicLeaf.
+   * @tparam T The type of the object.
+   * @tparam P Path type, or NodeHandle.
+   * @tparam F The type of the modifier, called as modifier(T &).
+   * @param path The path or handle of the object.
+   * @param modifier The modifier.
+   * @return true if an object of the type exists and the modifier was called.
+   */
+  template<typename T, typename P, typename F>
+  bool Modify(const P &path, F modifier) {
+    WriteLock l(mutex());
+    ObjectNode *node = Locate(path);
+    T *object = Lookup<T>(node);
+    if (!object) return false;
+    modifier(*object);
+    Changed(node);
+    return true;
+  }
+
+  /**
+   * @brief Get a handle to an atomic leaf, creating the path if necessary. A leaf that holds a number is converted to an
+   * atomic with the same value, cast to V. Updates through the handle take no tree lock, and GetObject of any number
+   * type reads the atomic value, cast to that type. Resolve the handle once and keep it for the updates.
+   * @tparam V The type of the leaf: std::int64_t, double or bool.
+   * @tparam P Path type.
+   * @param path The path of the leaf.
+   * @return The handle, empty if the path is empty or the leaf is an atomic of another type.
+   */
+  template<typename V, typename P>
+  AtomicLeaf<V> GetAtomic(const P &path) {
+    static_assert(IsAtomicLeafType<V>::value, "atomic leaves hold std::int64_t, double or bool");
+    {
+      ReadLock l(mutex());
+      ObjectNode *node = GetRootNode().Find(path);
+      AtomicCell<V> *cell = node ? node->data().template get<AtomicCell<V>>() : nullptr;
+      if (cell) return AtomicLeaf<V>(*cell);
+    }
+    WriteLock l(mutex());
+    ObjectNode *node = GetRootNode().Find(path);
+    if (node && IsAtomic(*node)) {
+      AtomicCell<V> *cell = node->data().template get<AtomicCell<V>>();
+      return cell ? AtomicLeaf<V>(*cell) : AtomicLeaf<V>();
+    }
+    if (!node) node = AddNode(path);
+    if (!node) return AtomicLeaf<V>();
+    V value = V();
+    LoadNumber(*node, value);
+    AtomicCell<V> cell = std::make_shared<std::atomic<V>>(value);
+    ReleaseSlot(*node);
+    node->SetData(cell);
+    Changed(node);
+    return AtomicLeaf<V>(cell);
+  }
+
+  /**
+   * @brief Keep the leaves of a primitive type in a column from now on. Leaves set before keep their value in the node.
+   * @tparam V The type, e.g. double.
+   */
+  template<typename V>
+  void RegisterColumn() {
+    static_assert(IsLeafColumnType<V>::value, "columns hold arithmetic types other than bool");
+    WriteLock l(mutex());
+    if (Column<V>()) return;
+    columns_.emplace_back(new LeafColumn<V>());
+    loaders_.push_back(&LoadColumn<V>);
+  }
+
+  /**
+   * @brief Summarise the leaves of a column at and below a path: their count, sum, min and max. The slots below the
+   * path are cached, so repeated summaries only run over the packed values until a leaf of the column is added or
+   * removed. Leaves of the type that are not in the column are not counted.
+   * @tparam V The type of the column.
+   * @tparam P Path type.
+   * @param path The path of the subtree, "" for the whole tree.
+   * @return The summary, empty if the column is not registered or the path does not exist.
+   */
+  template<typename V, typename P>
+  ColumnSummary<V> Summarize(const P &path) {
+    std::string key = PathString(path);
+    ReadLock l(mutex());
+    LeafColumn<V> *column = Column<V>();
+    ObjectNode *node = key.empty() ? rootNode() : GetRootNode().Find(path);
+    if (!column || !node) return ColumnSummary<V>();
+    return column->Summarize(key, [column, node](std::vector<std::uint32_t> &slots) {
+      CollectSlots(column, node, slots);
+    });
   }
 
   /**
@@ -168,9 +559,399 @@ class ObjectPropertyTree : public PropertyTree<std::string, boost::any> {
    * @param output_stream The stream to print to. Default is std::cout.
    */
   void PrintTree(std::ostream &output_stream = std::cout) {
+    ReadLock l(mutex());
     PrintNode(output_stream, rootNode());
   }
 
+ protected:
+  /**
+   * @brief Release the column slots of the leaves that are about to be removed.
+   * @param node The node.
+   */
+  void BeforeRemove(ObjectNode &node) override {
+    if (columns_.empty()) return;
+    ColumnSlot *slot = node.data().get<ColumnSlot>();
+    if (slot) slot->column->Release(slot->slot);
+    for (auto &child : node.children()) {
+      if (child.second) BeforeRemove(*child.second);
+    }
+  }
+
+  /**
+   * @brief Release the column slot of a leaf that SetData or Apply is about to replace.
+   * @param node The node.
+   */
+  void BeforeSet(ObjectNode &node) override {
+    if (!columns_.empty()) ReleaseSlot(node);
+  }
+
+  /**
+   * @brief Copy the data of a node for GetData, the value itself for a leaf of a column.
+   * @param node The node.
+   * @param data Receives the data.
+   */
+  void LoadData(ObjectNode &node, ObjectValue &data) override {
+    ColumnSlot *slot = columns_.empty() ? nullptr : node.data().get<ColumnSlot>();
+    if (!slot) {
+      data = node.data();
+      return;
+    }
+    for (std::size_t i = 0; i < columns_.size(); i++) {
+      if (columns_[i].get() == slot->column) loaders_[i](slot->column, slot->slot, data);
+    }
+  }
+
+ private:
+  /**
+   * @brief Get the column of a type. The caller must hold the lock.
+   * @tparam V The type.
+   * @return The column or nullptr if it is not registered.
+   */
+  template<typename V>
+  LeafColumn<V> *Column() {
+    for (auto &column : columns_) {
+      if (column->type() == TypeId::Of<V>()) return static_cast<LeafColumn<V> *>(column.get());
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Get the object of a node, whether it is stored in the node or in a column. The caller must hold the lock.
+   * @tparam T The type of the object.
+   * @param object_node The node or nullptr.
+   * @return A pointer to the object or nullptr if the node does not hold a T.
+   */
+  template<typename T>
+  static T *Lookup(ObjectNode *object_node) {
+    if (!object_node) return nullptr;
+    T *object = object_node->data().template get<T>();
+    return object ? object : LookupColumn<T>(object_node);
+  }
+
+  /**
+   * @brief Get the object of a node from a column. The caller must hold the lock.
+   * @tparam T The type of the object.
+   * @param object_node The node.
+   * @return A pointer to the object or nullptr if the node does not refer to the column of T.
+   */
+  template<typename T>
+  static typename std::enable_if<IsLeafColumnType<T>::value, T *>::type LookupColumn(ObjectNode *object_node) {
+    ColumnSlot *slot = object_node->data().template get<ColumnSlot>();
+    if (slot && slot->column->type() == TypeId::Of<T>()) {
+      return &static_cast<LeafColumn<T> *>(slot->column)->at(slot->slot);
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Types that cannot be kept in a column are never found in one.
+   */
+  template<typename T>
+  static typename std::enable_if<!IsLeafColumnType<T>::value, T *>::type LookupColumn(ObjectNode *) {
+    return nullptr;
+  }
+
+  /**
+   * @brief Copy a value out of a column.
+   * @tparam V The type of the values of the column.
+   * @param column The column.
+   * @param slot The slot of the value.
+   * @param data Receives the value.
+   */
+  template<typename V>
+  static void LoadColumn(LeafColumnBase *column, std::uint32_t slot, ObjectValue &data) {
+    data.emplace<V>(static_cast<LeafColumn<V> *>(column)->at(slot));
+  }
+
+  /**
+   * @brief Get the node at a path. The caller must hold the lock.
+   * @tparam P Path type.
+   * @param path The path.
+   * @return The node or nullptr.
+   */
+  template<typename P>
+  ObjectNode *Locate(const P &path) { return GetRootNode().Find(path); }
+
+  /**
+   * @brief Get the node of a handle. The caller must hold the lock.
+   * @param handle The handle.
+   * @return The node or nullptr if the handle is stale.
+   */
+  ObjectNode *Locate(const NodeHandle &handle) { return GetHandleNode(handle); }
+
+  /**
+   * @brief Get the node at a path relative to the node of a handle. The caller must hold the lock.
+   * @tparam P Path type.
+   * @param base The handle.
+   * @param path The path below the base.
+   * @return The node or nullptr if the base is stale or no node exists at the path.
+   */
+  template<typename P>
+  ObjectNode *FindBelow(const NodeHandle &base, const P &path) {
+    ObjectNode *node = GetHandleNode(base);
+    return node ? node->Find(path) : nullptr;
+  }
+
+  /**
+   * @brief Make the update that sets an object, in the atomic the leaf holds or in the column of its type if there is
+   * one. Otherwise the object is copied or moved into the node. An atomic leaf keeps its cell, so the handles to it
+   * stay attached: numbers are converted to the type of the cell and other objects are refused.
+   * @tparam T The type of the object.
+   * @param object The object, referenced by the update.
+   * @return The update, called under the write lock as update(node). It returns false if it refused the object.
+   */
+  template<typename T>
+  auto Setter(T &&object) {
+    typedef typename std::decay<T>::type V;
+    return [this, &object](ObjectNode &node) {
+      if (StoreAtomic<V>(node, object) || StoreColumn<V>(node, object)) return true;
+      if (IsAtomic(node)) return false;
+      ReleaseSlot(node);
+      node.data() = std::forward<T>(object);
+      return true;
+    };
+  }
+
+  /**
+   * @brief Set an object, see Setter.
+   * @tparam P Path type.
+   * @tparam T The type of the object.
+   * @param path The path or handle to store the object.
+   * @param object The object, moved if it is an rvalue.
+   * @return false if the path is empty, the handle is stale or the object was refused.
+   */
+  template<typename P, typename T>
+  bool Store(const P &path, T &&object) {
+    bool stored = false;
+    auto setter = Setter(std::forward<T>(object));
+    return Update(path, [&setter, &stored](ObjectNode &node) { stored = setter(node); }) && stored;
+  }
+
+  /**
+   * @brief Construct an object in a node. Types that belong in an atomic leaf or a column are constructed first and
+   * stored as by SetObject. The caller must hold the write lock.
+   * @tparam T The type of the object.
+   * @tparam A The types of the constructor arguments.
+   * @param node The node.
+   * @param arguments The constructor arguments.
+   * @return false if the node is an atomic leaf and T is not a number, see Setter.
+   */
+  template<typename T, typename... A>
+  bool EmplaceIn(ObjectNode &node, A &&... arguments) {
+    return EmplaceIn<T>(std::is_arithmetic<T>(), node, std::forward<A>(arguments)...);
+  }
+
+  /**
+   * @brief Construct a number and store it as by SetObject.
+   */
+  template<typename T, typename... A>
+  bool EmplaceIn(std::true_type, ObjectNode &node, A &&... arguments) {
+    return Setter(T(std::forward<A>(arguments)...))(node);
+  }
+
+  /**
+   * @brief Construct any other object in place in the node.
+   */
+  template<typename T, typename... A>
+  bool EmplaceIn(std::false_type, ObjectNode &node, A &&... arguments) {
+    if (IsAtomic(node)) return false;
+    ReleaseSlot(node);
+    node.data().template emplace<T>(std::forward<A>(arguments)...);
+    return true;
+  }
+
+  /**
+   * @brief Release the column slot a node refers to, before its data is replaced. The caller must hold the write lock.
+   * @param node The node.
+   */
+  static void ReleaseSlot(ObjectNode &node) {
+    ColumnSlot *slot = node.data().get<ColumnSlot>();
+    if (slot) slot->column->Release(slot->slot);
+  }
+
+  /**
+   * @brief Set an object in the column of its type. The caller must hold the write lock.
+   * @tparam T The type of the object.
+   * @param node The node.
+   * @param object The object.
+   * @return true if the type has a column.
+   */
+  template<typename T>
+  typename std::enable_if<IsLeafColumnType<T>::value, bool>::type StoreColumn(ObjectNode &node, const T &object) {
+    LeafColumn<T> *column = columns_.empty() ? nullptr : Column<T>();
+    if (!column) return false;
+    ColumnSlot *slot = node.data().template get<ColumnSlot>();
+    if (slot && slot->column == column) {
+      column->at(slot->slot) = object;
+      return true;
+    }
+    if (slot) slot->column->Release(slot->slot);
+    node.SetData(ColumnSlot{column, column->Add(object)});
+    return true;
+  }
+
+  /**
+   * @brief Types that cannot be kept in a column are stored in the node.
+   */
+  template<typename T>
+  typename std::enable_if<!IsLeafColumnType<T>::value, bool>::type StoreColumn(ObjectNode &, const T &) {
+    return false;
+  }
+
+  /**
+   * @brief Read the value of an atomic leaf, converted to the type asked for. The caller must hold the lock.
+   * @tparam T The type of the value.
+   * @param object_node The node or nullptr.
+   * @param object Receives the value.
+   * @return true if the node holds an atomic cell.
+   */
+  template<typename T>
+  static typename std::enable_if<std::is_arithmetic<T>::value, bool>::type LoadAtomic(ObjectNode *object_node,
+                                                                                      T &object) {
+    if (!object_node) return false;
+    ObjectValue &data = object_node->data();
+    if (AtomicCell<std::int64_t> *cell = data.get<AtomicCell<std::int64_t>>()) {
+      object = static_cast<T>((*cell)->load());
+    } else if (AtomicCell<double> *cell = data.get<AtomicCell<double>>()) {
+      object = static_cast<T>((*cell)->load());
+    } else if (AtomicCell<bool> *cell = data.get<AtomicCell<bool>>()) {
+      object = static_cast<T>((*cell)->load());
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Only numbers are read from atomic leaves.
+   */
+  template<typename T>
+  static typename std::enable_if<!std::is_arithmetic<T>::value, bool>::type LoadAtomic(ObjectNode *, T &) {
+    return false;
+  }
+
+  /**
+   * @brief Pass the value of an atomic leaf to a reader. The caller must hold the lock.
+   * @tparam T The type of the value.
+   * @tparam F The type of the reader.
+   * @param object_node The node or nullptr.
+   * @param reader The reader, called as reader(const T &).
+   * @return true if the node holds an atomic cell.
+   */
+  template<typename T, typename F>
+  static typename std::enable_if<std::is_arithmetic<T>::value, bool>::type ReadAtomic(ObjectNode *object_node,
+                                                                                      F &reader) {
+    T object;
+    if (!LoadAtomic(object_node, object)) return false;
+    reader(static_cast<const T &>(object));
+    return true;
+  }
+
+  /**
+   * @brief Only numbers are read from atomic leaves.
+   */
+  template<typename T, typename F>
+  static typename std::enable_if<!std::is_arithmetic<T>::value, bool>::type ReadAtomic(ObjectNode *, F &) {
+    return false;
+  }
+
+  /**
+   * @brief Set the value of an atomic leaf, so the handles to it see the change. The number is converted to the type
+   * of the cell. The caller must hold the write lock.
+   * @tparam T The type of the value.
+   * @param node The node.
+   * @param object The value.
+   * @return true if the node holds an atomic cell.
+   */
+  template<typename T>
+  static typename std::enable_if<std::is_arithmetic<T>::value, bool>::type StoreAtomic(ObjectNode &node,
+                                                                                       const T &object) {
+    ObjectValue &data = node.data();
+    if (AtomicCell<std::int64_t> *cell = data.get<AtomicCell<std::int64_t>>()) {
+      (*cell)->store(static_cast<std::int64_t>(object));
+    } else if (AtomicCell<double> *cell = data.get<AtomicCell<double>>()) {
+      (*cell)->store(static_cast<double>(object));
+    } else if (AtomicCell<bool> *cell = data.get<AtomicCell<bool>>()) {
+      (*cell)->store(static_cast<bool>(object));
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Only numbers are stored in atomic leaves.
+   */
+  template<typename T>
+  static typename std::enable_if<!std::is_arithmetic<T>::value, bool>::type StoreAtomic(ObjectNode &, const T &) {
+    return false;
+  }
+
+  /**
+   * @brief Read the number a node holds, in the node or in a column, converted to a type. The caller must hold the lock.
+   * @tparam V The type to convert to.
+   * @param node The node.
+   * @param value Receives the number.
+   * @return true if the node holds a number.
+   */
+  template<typename V>
+  bool LoadNumber(ObjectNode &node, V &value) {
+    ObjectValue column_value;
+    if (node.data().template is<ColumnSlot>()) LoadData(node, column_value);
+    const ObjectValue &data = column_value.empty() ? node.data() : column_value;
+    return CastNumber<V, bool, char, signed char, unsigned char, wchar_t, char16_t, char32_t, short, unsigned short, int,
+                      unsigned int, long, unsigned long, long long, unsigned long long, float, double, long double>(
+        data, value);
+  }
+
+  /**
+   * @brief No number type is left to try.
+   */
+  template<typename V>
+  static bool CastNumber(const ObjectValue &, V &) {
+    return false;
+  }
+
+  /**
+   * @brief Convert a value to a type if it holds one of a list of number types.
+   * @tparam V The type to convert to.
+   * @tparam N The first number type.
+   * @tparam R The other number types.
+   * @param data The value.
+   * @param value Receives the number.
+   * @return true if the value holds one of the types.
+   */
+  template<typename V, typename N, typename... R>
+  static bool CastNumber(const ObjectValue &data, V &value) {
+    const N *number = data.template get<N>();
+    if (!number) return CastNumber<V, R...>(data, value);
+    value = static_cast<V>(*number);
+    return true;
+  }
+
+  /**
+   * @param node A node.
+   * @return true if the node is an atomic leaf.
+   */
+  static bool IsAtomic(ObjectNode &node) {
+    const ObjectValue &data = node.data();
+    return data.is<AtomicCell<std::int64_t>>() || data.is<AtomicCell<double>>() || data.is<AtomicCell<bool>>();
+  }
+
+  /**
+   * @brief Collect the slots of a column at and below a node.
+   * @param column The column.
+   * @param node The node.
+   * @param slots Receives the slots.
+   */
+  static void CollectSlots(const LeafColumnBase *column, ObjectNode *node, std::vector<std::uint32_t> &slots) {
+    ColumnSlot *slot = node->data().get<ColumnSlot>();
+    if (slot && slot->column == column) slots.push_back(slot->slot);
+    for (auto &child : node->children()) {
+      if (child.second) CollectSlots(column, child.second, slots);
+    }
+  }
+
 };
 
 #endif //OBJECT_PROPERTY_TREE_OBJECT_PROPERTY_TREE_H
@@ -0,0 +1,303 @@
+#ifndef OBJECT_PROPERTY_TREE_OBJECT_VALUE_H
+#define OBJECT_PROPERTY_TREE_OBJECT_VALUE_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "type_id.h"
+
+/**
+ * @brief A type-erased value for the object tree, a replacement for boost::any that keeps small values inline.
+ * Values that fit in two pointers and can be moved without throwing, e.g. scalars and std::shared_ptr, are stored in
+ * the value itself, so setting them does not allocate. Larger values are stored on the heap.
+ *
+ * Each stored type has one table of operations, and the type of a value is checked by comparing the address of that
+ * table, see is(). The type is also available as a TypeId, see type_id(), so no RTTI is needed.
+ */
+class ObjectValue {
+ public:
+  /**
+   * @brief The size of the inline storage.
+   */
+  static constexpr std::size_t INLINE_SIZE = 2 * sizeof(void *);
+
+  /**
+   * @brief Check if values of a type are stored inline.
+   * @tparam T The type of the value.
+   */
+  template<typename T>
+  struct IsInline : std::integral_constant<bool, sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(void *)
+      && std::is_nothrow_move_constructible<T>::value> {};
+
+ private:
+  /**
+   * @brief The inline storage or the pointer to the heap.
+   */
+  union Storage {
+    void *pointer; ///< The heap object.
+    alignas(void *) unsigned char buffer[INLINE_SIZE]; ///< The inline object.
+  };
+
+  /**
+   * @brief The operations for one stored type.
+   */
+  struct Operations {
+    bool trivial; ///< The value is inline and trivially copyable, copies are plain memory copies.
+    void (*copy)(const Storage &from, Storage &to); ///< Copy construct the value of from into to.
+    void (*move)(Storage &from, Storage &to); ///< Move the value of from into to and destroy it in from.
+    void (*destroy)(Storage &storage); ///< Destroy the value.
+    TypeId id; ///< The type of the value.
+  };
+
+  /**
+   * @brief The operations for a type stored inline.
+   * @tparam T The type of the value.
+   */
+  template<typename T>
+  struct InlineOperations {
+    static T *Get(Storage &storage) { return reinterpret_cast<T *>(storage.buffer); }
+    static const T *Get(const Storage &storage) { return reinterpret_cast<const T *>(storage.buffer); }
+    static void Copy(const Storage &from, Storage &to) { new(to.buffer) T(*Get(from)); }
+    static void Move(Storage &from, Storage &to) {
+      new(to.buffer) T(std::move(*Get(from)));
+      Get(from)->~T();
+    }
+    static void Destroy(Storage &storage) { Get(storage)->~T(); }
+    static const Operations table;
+  };
+
+  /**
+   * @brief The operations for a type stored on the heap.
+   * @tparam T The type of the value.
+   */
+  template<typename T>
+  struct HeapOperations {
+    static T *Get(Storage &storage) { return static_cast<T *>(storage.pointer); }
+    static const T *Get(const Storage &storage) { return static_cast<const T *>(storage.pointer); }
+    static void Copy(const Storage &from, Storage &to) { to.pointer = new T(*Get(from)); }
+    static void Move(Storage &from, Storage &to) {
+      to.pointer = from.pointer;
+      from.pointer = nullptr;
+    }
+    static void Destroy(Storage &storage) { delete Get(storage); }
+    static const Operations table;
+  };
+
+  /**
+   * @brief The operations for a type.
+   * @tparam T The type of the value.
+   */
+  template<typename T>
+  using OperationsFor = typename std::conditional<IsInline<T>::value, InlineOperations<T>, HeapOperations<T>>::type;
+
+  Storage storage_; ///< The value.
+  const Operations *operations_ = nullptr; ///< The operations of the stored type, nullptr if empty.
+
+ public:
+  /**
+   * @brief Create an empty value.
+   */
+  ObjectValue() noexcept = default;
+
+  /**
+   * @brief Create a value holding a copy of an object.
+   * @tparam T The type of the object.
+   * @param object The object.
+   */
+  template<typename T, typename U = typename std::decay<T>::type,
+      typename = typename std::enable_if<!std::is_same<U, ObjectValue>::value>::type>
+  ObjectValue(T &&object) { Construct<U>(std::forward<T>(object)); }
+
+  /**
+   * @brief Copy a value.
+   * @param other The value to copy.
+   */
+  ObjectValue(const ObjectValue &other) { CopyFrom(other); }
+
+  /**
+   * @brief Move a value. The other value is left empty.
+   * @param other The value to move.
+   */
+  ObjectValue(ObjectValue &&other) noexcept { MoveFrom(other); }
+
+  /**
+   * @brief Destroy the value.
+   */
+  ~ObjectValue() { clear(); }
+
+  /**
+   * @brief Copy a value.
+   * @param other The value to copy.
+   * @return This value.
+   */
+  ObjectValue &operator=(const ObjectValue &other) {
+    if (this != &other) {
+      if (other.operations_ && other.operations_->trivial && (!operations_ || operations_->trivial)) {
+        storage_ = other.storage_;
+        operations_ = other.operations_;
+      } else {
+        ObjectValue copy(other);
+        clear();
+        MoveFrom(copy);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Move a value. The other value is left empty.
+   * @param other The value to move.
+   * @return This value.
+   */
+  ObjectValue &operator=(ObjectValue &&other) noexcept {
+    if (this != &other) {
+      clear();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Replace the value with a copy of an object.
+   * @tparam T The type of the object.
+   * @param object The object.
+   * @return This value.
+   */
+  template<typename T, typename U = typename std::decay<T>::type,
+      typename = typename std::enable_if<!std::is_same<U, ObjectValue>::value>::type>
+  ObjectValue &operator=(T &&object) {
+    ObjectValue value(std::forward<T>(object));
+    clear();
+    MoveFrom(value);
+    return *this;
+  }
+
+  /**
+   * @brief Replace the value with an object constructed in place from arguments. The arguments must not refer to the
+   * current value, which is destroyed first.
+   * @tparam T The type of the object.
+   * @tparam A The types of the constructor arguments.
+   * @param arguments The constructor arguments.
+   * @return The new object.
+   */
+  template<typename T, typename... A>
+  T &emplace(A &&... arguments) {
+    clear();
+    Construct<T>(std::forward<A>(arguments)...);
+    return *OperationsFor<T>::Get(storage_);
+  }
+
+  /**
+   * @return true if there is no value.
+   */
+  bool empty() const { return operations_ == nullptr; }
+
+  /**
+   * @brief Destroy the value, leaving this empty.
+   */
+  void clear() {
+    if (operations_) {
+      if (!operations_->trivial) operations_->destroy(storage_);
+      operations_ = nullptr;
+    }
+  }
+
+  /**
+   * @brief Check the type of the value with a single compare, the same as type_id() == TypeId::Of<T>().
+   * @tparam T The type.
+   * @return true if the value is a T.
+   */
+  template<typename T>
+  bool is() const { return operations_ == &OperationsFor<T>::table; }
+
+  /**
+   * @brief Get the value if it is a T.
+   * @tparam T The type.
+   * @return A pointer to the value, or nullptr if it is empty or of another type.
+   */
+  template<typename T>
+  T *get() { return is<T>() ? OperationsFor<T>::Get(storage_) : nullptr; }
+
+  /**
+   * @brief Get the value if it is a T.
+   * @tparam T The type.
+   * @return A pointer to the value, or nullptr if it is empty or of another type.
+   */
+  template<typename T>
+  const T *get() const { return is<T>() ? OperationsFor<T>::Get(storage_) : nullptr; }
+
+  /**
+   * @return The id of the type of the value, TypeId::Of<void>() if it is empty.
+   */
+  TypeId type_id() const { return operations_ ? operations_->id : TypeId::Of<void>(); }
+
+ private:
+  /**
+   * @brief Construct a value in the empty storage.
+   * @tparam T The type of the value.
+   * @tparam A The types of the constructor arguments.
+   * @param arguments The constructor arguments.
+   */
+  template<typename T, typename... A>
+  typename std::enable_if<IsInline<T>::value>::type Construct(A &&... arguments) {
+    new(storage_.buffer) T(std::forward<A>(arguments)...);
+    operations_ = &InlineOperations<T>::table;
+  }
+
+  /**
+   * @brief Construct a value on the heap.
+   * @tparam T The type of the value.
+   * @tparam A The types of the constructor arguments.
+   * @param arguments The constructor arguments.
+   */
+  template<typename T, typename... A>
+  typename std::enable_if<!IsInline<T>::value>::type Construct(A &&... arguments) {
+    storage_.pointer = new T(std::forward<A>(arguments)...);
+    operations_ = &HeapOperations<T>::table;
+  }
+
+  /**
+   * @brief Copy another value into this empty value.
+   * @param other The value to copy.
+   */
+  void CopyFrom(const ObjectValue &other) {
+    if (other.operations_) {
+      if (other.operations_->trivial) {
+        storage_ = other.storage_;
+      } else {
+        other.operations_->copy(other.storage_, storage_);
+      }
+    }
+    operations_ = other.operations_;
+  }
+
+  /**
+   * @brief Move another value into this empty value, leaving the other empty.
+   * @param other The value to move.
+   */
+  void MoveFrom(ObjectValue &other) noexcept {
+    if (other.operations_) {
+      if (other.operations_->trivial) {
+        storage_ = other.storage_;
+      } else {
+        other.operations_->move(other.storage_, storage_);
+      }
+    }
+    operations_ = other.operations_;
+    other.operations_ = nullptr;
+  }
+};
+
+template<typename T>
+const ObjectValue::Operations ObjectValue::InlineOperations<T>::table = {
+    std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+    &InlineOperations<T>::Copy, &InlineOperations<T>::Move, &InlineOperations<T>::Destroy, TypeId::Of<T>()
+};
+
+template<typename T>
+const ObjectValue::Operations ObjectValue::HeapOperations<T>::table = {
+    false, &HeapOperations<T>::Copy, &HeapOperations<T>::Move, &HeapOperations<T>::Destroy, TypeId::Of<T>()
+};
+
+#endif //OBJECT_PROPERTY_TREE_OBJECT_VALUE_H
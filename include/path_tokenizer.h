@@ -0,0 +1,182 @@
+#ifndef OBJECT_PROPERTY_TREE_PATH_TOKENIZER_H
+#define OBJECT_PROPERTY_TREE_PATH_TOKENIZER_H
+
+#include <cstddef>
+#include <iterator>
+#include <boost/utility/string_view.hpp>
+
+constexpr const char *DEFAULT_SEPARATOR = ".";
+
+/**
+ * @brief Splits a delimited path in place. The segments are views into the original string, so walking a path performs
+ * no heap allocations. Empty segments are skipped, e.g. "a..b" yields "a" and "b".
+ */
+class PathTokenizer {
+  boost::string_view path_; ///< The path being split. Must outlive the tokenizer.
+  boost::string_view separators_; ///< Any of these characters separates two segments.
+
+ public:
+  /**
+   * @brief A forward iterator over the segments of a path.
+   */
+  class iterator {
+    boost::string_view rest_; ///< The part of the path after the current segment.
+    boost::string_view separators_; ///< The segment separators.
+    boost::string_view segment_; ///< The current segment.
+    bool end_ = true; ///< True once all segments have been visited.
+
+    /**
+     * @brief Move to the next non-empty segment.
+     */
+    void Next() {
+      while (!rest_.empty()) {
+        std::size_t length = separators_.size() == 1 ? rest_.find(separators_[0]) : rest_.find_first_of(separators_);
+        if (length == boost::string_view::npos) length = rest_.size();
+        segment_ = rest_.substr(0, length);
+        rest_.remove_prefix(length < rest_.size() ? length + 1 : length);
+        if (!segment_.empty()) return;
+      }
+      end_ = true;
+    }
+
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef boost::string_view value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const boost::string_view *pointer;
+    typedef const boost::string_view &reference;
+
+    /**
+     * @brief Create an end iterator.
+     */
+    iterator() = default;
+
+    /**
+     * @brief Create an iterator positioned at the first segment of a path.
+     * @param path The path to split.
+     * @param separators The segment separators.
+     */
+    iterator(boost::string_view path, boost::string_view separators)
+        : rest_(path), separators_(separators), end_(false) {
+      Next();
+    }
+
+    reference operator*() const { return segment_; }
+    pointer operator->() const { return &segment_; }
+
+    iterator &operator++() {
+      Next();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator i = *this;
+      Next();
+      return i;
+    }
+
+    bool operator==(const iterator &other) const {
+      if (end_ || other.end_) return end_ == other.end_;
+      return segment_.data() == other.segment_.data();
+    }
+
+    bool operator!=(const iterator &other) const { return !(*this == other); }
+  };
+
+  typedef iterator const_iterator;
+
+  /**
+   * @brief Create a tokenizer for a path.
+   * @param path The path to split. The tokenizer keeps a view, the string must outlive it.
+   * @param separators The separator characters between segments.
+   */
+  explicit PathTokenizer(boost::string_view path, const char *separators = DEFAULT_SEPARATOR)
+      : path_(path), separators_(separators) {}
+
+  /**
+   * @return An iterator to the first segment.
+   */
+  iterator begin() const { return iterator(path_, separators_); }
+
+  /**
+   * @return The end iterator.
+   */
+  iterator end() const { return iterator(); }
+
+  /**
+   * @return true if the path has no segments.
+   */
+  bool empty() const { return begin() == end(); }
+
+  /**
+   * @return The number of segments in the path.
+   */
+  std::size_t size() const { return static_cast<std::size_t>(std::distance(begin(), end())); }
+};
+
+/**
+ * @brief A non-owning view of a contiguous list of path segments, e.g. a NodePath or an array of string views.
+ * @tparam S The type of the path segments.
+ */
+template<typename S>
+class PathSpan {
+  const S *data_ = nullptr; ///< The first segment.
+  std::size_t size_ = 0; ///< The number of segments.
+
+ public:
+  typedef S value_type;
+  typedef const S *iterator;
+  typedef const S *const_iterator;
+
+  /**
+   * @brief Create an empty span.
+   */
+  PathSpan() = default;
+
+  /**
+   * @brief Create a span over an array of segments.
+   * @param data The first segment.
+   * @param size The number of segments.
+   */
+  PathSpan(const S *data, std::size_t size) : data_(data), size_(size) {}
+
+  /**
+   * @brief Create a span over a contiguous container of segments such as a NodePath.
+   * @tparam Container The container type.
+   * @param segments The container. It must outlive the span.
+   */
+  template<typename Container>
+  PathSpan(const Container &segments) : data_(segments.data()), size_(segments.size()) {}
+
+  iterator begin() const { return data_; }
+  iterator end() const { return data_ + size_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const S &operator[](std::size_t i) const { return data_[i]; }
+  const S &front() const { return data_[0]; }
+  const S &back() const { return data_[size_ - 1]; }
+
+  /**
+   * @brief Get a part of this span.
+   * @param offset The first segment of the part.
+   * @param count The number of segments, the rest of the span by default.
+   * @return The part of the span.
+   */
+  PathSpan subspan(std::size_t offset, std::size_t count = static_cast<std::size_t>(-1)) const {
+    if (offset > size_) offset = size_;
+    if (count > size_ - offset) count = size_ - offset;
+    return PathSpan(data_ + offset, count);
+  }
+};
+
+/**
+ * @brief Get the segments of a path, for code that walks any of the path types.
+ * @param path A path.
+ * @return A range of segments. Strings are tokenized in place, other paths are returned as they are.
+ */
+template<typename S>
+inline const PathSpan<S> &PathSegments(const PathSpan<S> &path) { return path; }
+inline const PathTokenizer &PathSegments(const PathTokenizer &path) { return path; }
+inline PathTokenizer PathSegments(boost::string_view path) { return PathTokenizer(path); }
+
+#endif //OBJECT_PROPERTY_TREE_PATH_TOKENIZER_H
@@ -0,0 +1,214 @@
+#ifndef OBJECT_PROPERTY_TREE_POINTER_POOL_H
+#define OBJECT_PROPERTY_TREE_POINTER_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/**
+ * @brief Memory for the objects a tree keeps behind shared pointers, see ObjectPropertyTree::EmplacePointer. Blocks
+ * are carved from chunks in size classes of GRANULE bytes and freed blocks are reused by the next allocation of their
+ * class, so storing a pooled object does not go to the heap once the pool has warmed up. Larger blocks are taken from
+ * the heap. Alignments above alignof(std::max_align_t) are not supported, see PoolAllocator.
+ *
+ * Shared pointers may be released on any thread, so the pool has a mutex of its own. They may also outlive the owner
+ * of the pool, so the pool is created on the heap and deleted when it has been closed and its last block is freed.
+ */
+class PointerPool {
+ public:
+  /**
+   * @brief Closes a pool, for std::unique_ptr.
+   */
+  struct Closer {
+    void operator()(PointerPool *pool) const { pool->Close(); }
+  };
+
+  /**
+   * @brief The owner of a pool.
+   */
+  typedef std::unique_ptr<PointerPool, Closer> Owner;
+
+  static constexpr std::size_t GRANULE = 16; ///< The size step and alignment of the blocks.
+  static constexpr std::size_t CLASSES = 16; ///< The number of size classes, up to CLASSES * GRANULE bytes.
+  static constexpr std::size_t CHUNK_SIZE = 16384; ///< The size of the chunks the blocks are carved from.
+
+ private:
+  /**
+   * @brief A free block.
+   */
+  struct FreeBlock {
+    FreeBlock *next; ///< The next free block of the class.
+  };
+
+  std::mutex mutex_; ///< Guards the pool.
+  std::vector<std::unique_ptr<unsigned char[]>> chunks_; ///< The chunks.
+  FreeBlock *free_[CLASSES] = {}; ///< The free blocks by size class.
+  unsigned char *next_ = nullptr; ///< The next unused byte in the last chunk.
+  unsigned char *end_ = nullptr; ///< The end of the last chunk.
+  std::size_t size_ = 0; ///< The number of live blocks.
+  bool closed_ = false; ///< The owner has given up the pool.
+
+  PointerPool() = default;
+  ~PointerPool() = default;
+
+ public:
+  PointerPool(const PointerPool &) = delete;
+  PointerPool &operator=(const PointerPool &) = delete;
+
+  /**
+   * @brief Create an empty pool. The first chunk is allocated by the first Allocate.
+   * @return The owner of the pool.
+   */
+  static Owner Create() { return Owner(new PointerPool()); }
+
+  /**
+   * @brief Give up the pool. It is deleted now if no block is live, otherwise when the last block is freed.
+   */
+  void Close() {
+    bool last;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      closed_ = true;
+      last = size_ == 0;
+    }
+    if (last) delete this;
+  }
+
+  /**
+   * @brief Allocate a block.
+   * @param size The size of the block.
+   * @param alignment The alignment of the block, at most alignof(std::max_align_t).
+   * @return The block.
+   */
+  void *Allocate(std::size_t size, std::size_t alignment) {
+    if (!Pooled(size, alignment)) {
+      void *memory = ::operator new(size);
+      std::lock_guard<std::mutex> l(mutex_);
+      size_++;
+      return memory;
+    }
+    std::size_t size_class = SizeClass(size);
+    std::lock_guard<std::mutex> l(mutex_);
+    FreeBlock *block = free_[size_class];
+    if (block) {
+      free_[size_class] = block->next;
+      size_++;
+      return block;
+    }
+    std::size_t block_size = (size_class + 1) * GRANULE;
+    if (static_cast<std::size_t>(end_ - next_) < block_size) {
+      chunks_.reserve(chunks_.size() + 1);
+      chunks_.emplace_back(new unsigned char[CHUNK_SIZE]);
+      next_ = chunks_.back().get();
+      end_ = next_ + CHUNK_SIZE;
+    }
+    void *memory = next_;
+    next_ += block_size;
+    size_++;
+    return memory;
+  }
+
+  /**
+   * @brief Free a block for reuse.
+   * @param memory The block.
+   * @param size The size it was allocated with.
+   * @param alignment The alignment it was allocated with.
+   */
+  void Deallocate(void *memory, std::size_t size, std::size_t alignment) {
+    bool pooled = Pooled(size, alignment);
+    if (!pooled) ::operator delete(memory);
+    bool last;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (pooled) {
+        std::size_t size_class = SizeClass(size);
+        free_[size_class] = new(memory) FreeBlock{free_[size_class]};
+      }
+      last = --size_ == 0 && closed_;
+    }
+    if (last) delete this;
+  }
+
+  /**
+   * @return The number of live blocks.
+   */
+  std::size_t size() {
+    std::lock_guard<std::mutex> l(mutex_);
+    return size_;
+  }
+
+  /**
+   * @return The number of bytes in chunks.
+   */
+  std::size_t capacity() {
+    std::lock_guard<std::mutex> l(mutex_);
+    return chunks_.size() * CHUNK_SIZE;
+  }
+
+ private:
+  /**
+   * @return true if blocks of a size and alignment are carved from chunks.
+   */
+  static bool Pooled(std::size_t size, std::size_t alignment) {
+    return size <= CLASSES * GRANULE && alignment <= GRANULE && alignof(std::max_align_t) >= GRANULE;
+  }
+
+  /**
+   * @return The size class of a block size.
+   */
+  static std::size_t SizeClass(std::size_t size) { return size ? (size - 1) / GRANULE : 0; }
+};
+
+/**
+ * @brief A standard allocator that takes its memory from a PointerPool, for std::allocate_shared. The control block of
+ * a shared pointer keeps a copy of the allocator, a single pointer, and the blocks it has handed out keep the pool
+ * alive, see PointerPool::Close.
+ * @tparam T The type of the values. Over-aligned types are rejected, the heap blocks of the pool come from plain
+ * ::operator new, which only guarantees alignof(std::max_align_t) in C++14.
+ */
+template<typename T>
+class PoolAllocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator does not support over-aligned types");
+
+  template<typename U> friend class PoolAllocator;
+
+  PointerPool *pool_; ///< The pool.
+
+ public:
+  typedef T value_type;
+
+  /**
+   * @brief Create an allocator.
+   * @param pool The pool.
+   */
+  explicit PoolAllocator(PointerPool *pool) : pool_(pool) {}
+
+  /**
+   * @brief Create an allocator for another type from the same pool.
+   * @param other The allocator.
+   */
+  template<typename U>
+  PoolAllocator(const PoolAllocator<U> &other) : pool_(other.pool_) {}
+
+  /**
+   * @param count The number of values.
+   * @return Memory for the values.
+   */
+  T *allocate(std::size_t count) { return static_cast<T *>(pool_->Allocate(count * sizeof(T), alignof(T))); }
+
+  /**
+   * @param values The memory of the values.
+   * @param count The number of values.
+   */
+  void deallocate(T *values, std::size_t count) { pool_->Deallocate(values, count * sizeof(T), alignof(T)); }
+
+  template<typename U>
+  bool operator==(const PoolAllocator<U> &other) const { return pool_ == other.pool_; }
+
+  template<typename U>
+  bool operator!=(const PoolAllocator<U> &other) const { return pool_ != other.pool_; }
+};
+
+#endif //OBJECT_PROPERTY_TREE_POINTER_POOL_H
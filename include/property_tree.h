@@ -1,9 +1,15 @@
 #ifndef OBJECT_PROPERTY_TREE_PROPERTY_TREE_H
 #define OBJECT_PROPERTY_TREE_PROPERTY_TREE_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <boost/thread.hpp>
 #include "node.h"
 #include "node_path.h"
+#include "node_table.h"
+#include "subscription_manager.h"
+#include "write_batch.h"
 
 // Mutexs - tree access needs to be thread safe.
 typedef boost::shared_mutex ReadWriteMutex;
@@ -14,32 +20,43 @@ typedef boost::unique_lock<boost::shared_mutex> WriteLock;
  * @brief A generic property tree.
  * @tparam K The type of the key.
  * @tparam T The type of the value.
+ * @tparam C The children container policy of the nodes, see node_children.h.
+ * @tparam A The node allocation policy, see node_allocator.h.
  */
-template<typename K, typename T>
+template<typename K, typename T, typename C = MapChildren, typename A = HeapAllocation>
 class PropertyTree {
   mutable ReadWriteMutex mutex_; ///< Mutex for read/write access.
-  bool changed_ = false; ///< Track if any action may have changed the tree.
+  std::atomic<std::uint64_t> generation_{0}; ///< Counts the actions that may have changed the tree.
+  std::atomic<std::uint64_t> cleared_generation_{0}; ///< The generation at the last ClearChanged.
 
  public:
   /**
    * @brief A node type with matching key and value types.
    */
-  typedef Node<K, T> PropertyNode;
+  typedef Node<K, T, C> PropertyNode;
 
   /**
    * @brief A npde path type with matching key type.
    */
   typedef NodePath<K> Path;
 
+  /**
+   * @brief The allocator of the nodes.
+   */
+  typedef typename A::template Allocator<PropertyNode> NodeAllocator;
+
  private:
+  NodeAllocator allocator_; ///< Creates and destroys the nodes below the root.
+  NodeTable<PropertyNode> handles_; ///< The nodes that handles were made for, declared before them to outlive them.
   PropertyNode root_; ///< The root node.
+  SubscriptionManager subscriptions_; ///< Delivers changes to subscribers.
 
  public:
 
   /**
    * @brief Create a property tree.
    */
-  PropertyTree() : root_("__ROOT__") {
+  PropertyTree() : root_(NodeKeyTraits<K>::Make("__ROOT__")) {
     root_.ClearChildren();
   }
 
@@ -47,7 +64,10 @@ class PropertyTree {
    * @brief Delete the property tree.
    */
   virtual ~PropertyTree() {
-    root_.ClearChildren();
+    // A callback that is running may still read the tree.
+    subscriptions_.Stop();
+    root_.DestroyChildren(allocator_);
+    allocator_.Release();
   }
 
   /**
@@ -56,53 +76,211 @@ class PropertyTree {
   ReadWriteMutex &mutex() { return mutex_; }
 
   /**
-   * @return The changed flag. True if something has changed.
+   * @return The changed flag. True if something has changed since the last ClearChanged.
+   */
+  bool changed() const { return generation_.load() != cleared_generation_.load(); }
+
+  /**
+   * @return The generation of the tree. It goes up with every action that may have changed the tree, so pollers can
+   * compare generations instead of clearing a shared flag.
    */
-  bool changed() const { return changed_; }
+  std::uint64_t generation() const { return generation_.load(); }
 
   /**
-   * @brief Set changed to false.
+   * @brief Set changed to false. A change made at the same time may be reported by the next changed() as well.
    */
-  void ClearChanged() { changed_ = false; }
+  void ClearChanged() { cleared_generation_.store(generation_.load()); }
 
   /**
    * @brief Set the changed flag. Default is true.
-   * @param changed The flag to set.
+   * @param changed The flag to set. true advances the generation, false is ClearChanged.
    */
-  void SetChanged(bool changed = true) { changed_ = changed; }
+  void SetChanged(bool changed = true) {
+    if (changed) {
+      NextGeneration();
+    } else {
+      ClearChanged();
+    }
+  }
 
   /**
    * @brief Clear / delete all nodes (other than root) from the tree.
    */
   void clear() {
     WriteLock l(mutex_);
-    root_.ClearChildren();
-    SetChanged();
+    for (auto &child : root_.children()) {
+      if (child.second) BeforeRemove(*child.second);
+    }
+    root_.DestroyChildren(allocator_);
+    allocator_.Release();
+    std::uint64_t generation = NextGeneration();
+    root_.Stamp(generation);
+    if (subscriptions_.active()) subscriptions_.Publish(std::string(), ChangeEvent::REMOVED, generation);
+  }
+
+  /**
+   * @brief Purge null entries left in the child maps of the tree.
+   * @return The number of entries purged.
+   */
+  std::size_t compact() {
+    WriteLock l(mutex_);
+    return root_.Compact();
+  }
+
+  /**
+   * @brief Subscribe to the changes made by SetData, remove and clear, see SubscriptionManager.
+   * @param pattern The path pattern, segments may be "*" for any one segment.
+   * @param callback Called off the writer's thread with coalesced batches of changes.
+   * @return The id of the subscription.
+   */
+  std::size_t Subscribe(boost::string_view pattern, SubscriptionManager::Callback callback) {
+    return subscriptions_.Subscribe(pattern, std::move(callback));
   }
 
+  /**
+   * @brief Cancel a subscription.
+   * @param id The id of the subscription.
+   */
+  void Unsubscribe(std::size_t id) { subscriptions_.Unsubscribe(id); }
+
+  /**
+   * @return The subscription manager.
+   */
+  SubscriptionManager &subscriptions() { return subscriptions_; }
+
+  /**
+   * @return The node allocator.
+   */
+  const NodeAllocator &allocator() const { return allocator_; }
+
   /**
    * @return A pointer to the root node.
    */
   PropertyNode *rootNode() { return &this->root_; }
 
   /**
-   * @brief Set data for a node. Path is created if necessary.
+   * @brief Set data for a node. Path is created if necessary. The lookup, any creation and the assignment happen under
+   * one write lock, so concurrent writers to the same path cannot create it twice or interleave. The node is stamped
+   * with the new generation.
    * @tparam P Path type.
    * @param path The path of the node to set.
    * @param data The data to set at path.
    */
   template<typename P>
   void SetData(const P &path, const T &data) {
-    auto node = root_.Find(path);
-    if (!node) {
-      WriteLock l(mutex_);
-      node = root_.Add(path);
-    }
-    if (node) {
-      WriteLock l(mutex_);
-      node->SetData(data);
+    Update(path, [this, &data](PropertyNode &node) {
+      BeforeSet(node);
+      node.SetData(data);
+    });
+  }
+
+  /**
+   * @brief Set data for a node by moving it, see SetData.
+   * @tparam P Path type.
+   * @param path The path of the node to set.
+   * @param data The data to move to the node.
+   */
+  template<typename P>
+  void SetData(const P &path, T &&data) {
+    Update(path, [this, &data](PropertyNode &node) {
+      BeforeSet(node);
+      node.SetData(std::move(data));
+    });
+  }
+
+  /**
+   * @brief Set data for the node of a handle.
+   * @param handle The handle, see Resolve.
+   * @param data The data to set.
+   * @return false if the handle is stale.
+   */
+  bool SetData(const NodeHandle &handle, const T &data) {
+    return Update(handle, [this, &data](PropertyNode &node) {
+      BeforeSet(node);
+      node.SetData(data);
+    });
+  }
+
+  /**
+   * @brief Set data for the node of a handle by moving it.
+   * @param handle The handle, see Resolve.
+   * @param data The data to move to the node.
+   * @return false if the handle is stale.
+   */
+  bool SetData(const NodeHandle &handle, T &&data) {
+    return Update(handle, [this, &data](PropertyNode &node) {
+      BeforeSet(node);
+      node.SetData(std::move(data));
+    });
+  }
+
+  /**
+   * @brief Apply a batch of set and remove operations under one write lock. Readers and subscribers see either none or
+   * all of the batch, and all changes share one generation. Between removes, the sets are applied in path order so
+   * that consecutive paths descend from their common prefix instead of from the root; sets to the same path keep
+   * their order.
+   * @param batch The batch.
+   */
+  void Apply(const WriteBatch<K, T> &batch) {
+    if (batch.empty()) return;
+    WriteLock l(mutex_);
+    std::uint64_t generation = NextGeneration();
+    bool publish = subscriptions_.active();
+    std::vector<ChangeEvent> events;
+    std::vector<std::pair<boost::string_view, std::size_t>> sets; // the paths and indices of a run of sets
+    std::vector<PropertyNode *> nodes; // the nodes along the previous path, starting with the root
+    const char separator = DEFAULT_SEPARATOR[0];
+    auto &operations = batch.operations();
+    for (std::size_t i = 0; i < operations.size();) {
+      if (operations[i].remove) {
+        auto path = batch.path(operations[i]);
+        auto node = root_.Find(path);
+        if (node) {
+          auto parent = node->parent();
+          BeforeRemove(*node);
+          node->Destroy(allocator_);
+          parent->Stamp(generation);
+          if (publish) events.push_back(ChangeEvent{path.to_string(), ChangeEvent::REMOVED, generation});
+        }
+        i++;
+        continue;
+      }
+
+      sets.clear();
+      for (; i < operations.size() && !operations[i].remove; i++) sets.emplace_back(batch.path(operations[i]), i);
+      // Sorted by path, then by index, so sets to the same path keep the order they were added in.
+      std::sort(sets.begin(), sets.end());
+      nodes.assign(1, &root_);
+      boost::string_view previous;
+      for (auto &set : sets) {
+        auto path = set.first;
+        if (path.empty()) continue;
+        // Keep the nodes of the whole segments shared with the previous path and walk only the rest.
+        std::size_t shared = 0, depth = 0;
+        for (std::size_t c = 0;; c++) {
+          bool path_end = c == path.size() || path[c] == separator;
+          bool previous_end = c == previous.size() || previous[c] == separator;
+          if (path_end && previous_end) {
+            shared = c;
+            depth++;
+          }
+          if (c == path.size() || c == previous.size() || path[c] != previous[c]) break;
+        }
+        nodes.resize(depth + 1);
+        PropertyNode *node = nodes.back();
+        for (auto &&segment : PathTokenizer(path.substr(shared))) {
+          PropertyNode *child = node->FindChild(segment);
+          node = child ? child : node->CreateChild(NodeKeyTraits<K>::Make(segment), allocator_);
+          nodes.push_back(node);
+        }
+        BeforeSet(*node);
+        node->SetData(operations[set.second].data);
+        node->Stamp(generation);
+        if (publish) events.push_back(ChangeEvent{path.to_string(), ChangeEvent::SET, generation});
+        previous = path;
+      }
     }
-    SetChanged();
+    if (publish) subscriptions_.Publish(events);
   }
 
   /**
@@ -116,12 +294,112 @@ class PropertyTree {
     ReadLock l(mutex_);
     auto *p = root_.Find(path);
     if (p) {
-      data = p->data();
+      LoadData(*p, data);
+    }
+  }
+
+  /**
+   * @brief Get copies of the data at several paths under one read lock, so the values are consistent with each other.
+   * Paths that share a prefix with the path before them continue from there, see Node::FindEach.
+   * @tparam P Path type.
+   * @param paths The paths of the objects to get.
+   * @param data_list Receives the data for each path, T() where no node exists.
+   * @return The number of paths where a node exists.
+   */
+  template<typename P>
+  std::size_t GetData(const std::vector<P> &paths, std::vector<T> &data_list) {
+    data_list.assign(paths.size(), T());
+    std::size_t found = 0;
+    ReadLock l(mutex_);
+    root_.FindEach(paths, [this, &data_list, &found](std::size_t i, PropertyNode *node) {
+      if (node) {
+        LoadData(*node, data_list[i]);
+        found++;
+      }
+    });
+    return found;
+  }
+
+  /**
+   * @brief Get copies of the data at several paths below a common prefix under one read lock. The prefix is walked
+   * once, the leaves are found relative to it.
+   * @tparam P Path type of the prefix.
+   * @tparam L Path type of the leaves.
+   * @param prefix The path of the node the leaves are relative to, e.g. "session.42".
+   * @param leaves The paths of the objects relative to the prefix, e.g. "user" and "expires".
+   * @param data_list Receives the data for each leaf, T() where no node exists.
+   * @return The number of leaves where a node exists.
+   */
+  template<typename P, typename L>
+  std::size_t GetData(const P &prefix, const std::vector<L> &leaves, std::vector<T> &data_list) {
+    data_list.assign(leaves.size(), T());
+    std::size_t found = 0;
+    ReadLock l(mutex_);
+    auto node = root_.Find(prefix);
+    if (node) {
+      node->FindEach(leaves, [this, &data_list, &found](std::size_t i, PropertyNode *leaf) {
+        if (leaf) {
+          LoadData(*leaf, data_list[i]);
+          found++;
+        }
+      });
     }
+    return found;
+  }
+
+  /**
+   * @brief Get a copy of the data of the node of a handle. The handle is checked in constant time, without a walk.
+   * @param handle The handle, see Resolve.
+   * @param data A reference to collect the data object.
+   * @return false if the handle is stale.
+   */
+  bool GetData(const NodeHandle &handle, T &data) {
+    ReadLock l(mutex_);
+    auto *p = handles_.Get(handle);
+    if (!p) return false;
+    LoadData(*p, data);
+    return true;
+  }
+
+  /**
+   * @brief Make a handle to the node at a path, to reach the node again without walking the path. The handle is stale
+   * once the node is removed, even if a node is created at the same path again.
+   * @tparam P Path type.
+   * @param path The path of the node.
+   * @param create Create the node if it does not exist.
+   * @return The handle, or an empty handle if no node exists at the path.
+   */
+  template<typename P>
+  NodeHandle Resolve(const P &path, bool create = false) {
+    return ResolveBelow(nullptr, path, create);
+  }
+
+  /**
+   * @brief Make a handle to the node at a path relative to the node of another handle.
+   * @tparam P Path type.
+   * @param base The handle the path is relative to.
+   * @param path The path of the node below the base.
+   * @param create Create the node if it does not exist.
+   * @return The handle, or an empty handle if the base is stale or no node exists at the path.
+   */
+  template<typename P>
+  NodeHandle Resolve(const NodeHandle &base, const P &path, bool create = false) {
+    return ResolveBelow(&base, path, create);
+  }
+
+  /**
+   * @brief Check if the node of a handle still exists.
+   * @param handle The handle.
+   * @return true if the handle is not stale.
+   */
+  bool exists(const NodeHandle &handle) {
+    ReadLock l(mutex_);
+    return handles_.Get(handle) != nullptr;
   }
 
   /**
-   * @return A reference to the root node.
+   * @return A reference to the root node. Changes through the node API need the write lock, see mutex(). Nodes removed
+   * through it make their handles stale like remove does.
    */
   PropertyNode &GetRootNode() { return root_; }
 
@@ -161,19 +439,47 @@ class PropertyTree {
    */
   template<typename P>
   bool exists(const P &path) {
+    ReadLock l(mutex_);
     return root_.Find(path) != nullptr;
   }
 
   /**
-   * @brief Remove the node at path from the tree.
+   * @brief Remove the node at path from the tree. The parent of the node is stamped with the new generation.
    * @tparam P Path type.
    * @param path The path of the node to remove.
    */
   template<typename P>
   void remove(const P &path) {
     WriteLock l(mutex_);
-    SetChanged();
-    root_.Remove(path);
+    auto node = root_.Find(path);
+    if (node) {
+      auto parent = node->parent();
+      BeforeRemove(*node);
+      node->Destroy(allocator_);
+      std::uint64_t generation = NextGeneration();
+      parent->Stamp(generation);
+      if (subscriptions_.active()) subscriptions_.Publish(PathString(path), ChangeEvent::REMOVED, generation);
+    } else {
+      SetChanged();
+    }
+  }
+
+  /**
+   * @brief List the nodes that changed after a generation: nodes whose data was set and parents of removed nodes.
+   * Subtrees without changes are not visited, so the cost follows the number of changes rather than the size of the
+   * tree.
+   * @param generation The generation to compare with, usually the return value of the previous call.
+   * @param changed_list receives the full paths of the changed nodes, in tree order.
+   * @return The current generation, to pass to the next call.
+   */
+  std::uint64_t ListChanged(std::uint64_t generation, std::vector<Path> &changed_list) {
+    changed_list.clear();
+    ReadLock l(mutex_);
+    Path path;
+    root_.VisitChangedSince(generation, [&changed_list](const Path &node_path, PropertyNode &) {
+      changed_list.push_back(node_path);
+    }, path);
+    return generation_.load();
   }
 
   /**
@@ -185,11 +491,7 @@ class PropertyTree {
     path.clear();
     if (node) {
       ReadLock l(mutex_);
-      while (node->parent() != nullptr) {
-        path.push_back(node->name());
-        node = node->parent();
-      }
-      std::reverse(std::begin(path), std::end(path));
+      FullPath(node, path);
     }
   }
 
@@ -198,34 +500,251 @@ class PropertyTree {
    * @tparam P The path type.
    * @param path The path of the node to list.
    * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
    * @return The length of the list.
    */
   template<typename P>
-  unsigned long ListChildren(const P &path, std::vector<K> &children_list) {
+  unsigned long ListChildren(const P &path, std::vector<K> &children_list, bool sorted = false) {
     children_list.clear();
-    auto i = Find(path);
-    if (i) {
-      ReadLock lx(mutex_);
-      for (auto j = i->children().begin(); j != i->children().end(); j++) {
-        children_list.push_back(j->first);
-      }
+    {
+      ReadLock l(mutex_);
+      AppendChildren(root_.Find(path), children_list);
+    }
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
+    return children_list.size();
+  }
+
+  /**
+   * @brief List the children of a node relative to the node of a handle.
+   * @tparam P The path type.
+   * @param base The handle the path is relative to.
+   * @param path The path of the node to list below the base.
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list.
+   */
+  template<typename P>
+  unsigned long ListChildren(const NodeHandle &base, const P &path, std::vector<K> &children_list,
+                             bool sorted = false) {
+    children_list.clear();
+    {
+      ReadLock l(mutex_);
+      auto *node = handles_.Get(base);
+      if (node) AppendChildren(node->Find(path), children_list);
+    }
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
+    return children_list.size();
+  }
+
+  /**
+   * @brief List the children of the node of a handle.
+   * @param handle The handle.
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list, 0 if the handle is stale.
+   */
+  unsigned long ListChildren(const NodeHandle &handle, std::vector<K> &children_list, bool sorted = false) {
+    children_list.clear();
+    {
+      ReadLock l(mutex_);
+      AppendChildren(handles_.Get(handle), children_list);
     }
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
     return children_list.size();
   }
 
   /**
    * @brief List the children of the root node
    * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
    * @return The length of the list.
    */
-  unsigned long ListChildren(std::vector<K> &children_list) {
+  unsigned long ListChildren(std::vector<K> &children_list, bool sorted = false) {
     children_list.clear();
     ReadLock lx(mutex_);
     for (auto j = root_.children().begin(); j != root_.children().end(); j++) {
       children_list.push_back(j->first);
     }
+    if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
     return children_list.size();
   }
 
+ protected:
+  /**
+   * @brief Change the node at a path under the write lock, creating the path if necessary. The node is stamped with
+   * the new generation and the change is published to subscribers.
+   * @tparam P Path type.
+   * @tparam F The type of the update, called as update(node).
+   * @param path The path of the node.
+   * @param update Changes the data of the node.
+   * @return false if the path is empty.
+   */
+  template<typename P, typename F>
+  bool Update(const P &path, F update) {
+    WriteLock l(mutex_);
+    auto node = root_.FindOrEmplace(path, allocator_);
+    if (node) {
+      update(*node);
+      std::uint64_t generation = NextGeneration();
+      node->Stamp(generation);
+      if (subscriptions_.active()) subscriptions_.Publish(PathString(path), ChangeEvent::SET, generation);
+    } else {
+      SetChanged();
+    }
+    return node != nullptr;
+  }
+
+  /**
+   * @brief Change the node of a handle under the write lock, like Update with a path.
+   * @tparam F The type of the update, called as update(node).
+   * @param handle The handle.
+   * @param update Changes the data of the node.
+   * @return false if the handle is stale.
+   */
+  template<typename F>
+  bool Update(const NodeHandle &handle, F update) {
+    WriteLock l(mutex_);
+    auto node = handles_.Get(handle);
+    if (!node) return false;
+    update(*node);
+    Changed(node);
+    return true;
+  }
+
+  /**
+   * @brief Change the node at a path relative to the node of a handle under the write lock, creating the path if
+   * necessary. Only the path below the base is walked.
+   * @tparam P Path type.
+   * @tparam F The type of the update, called as update(node).
+   * @param base The handle the path is relative to.
+   * @param path The path of the node below the base.
+   * @param update Changes the data of the node.
+   * @return false if the base is stale or the path is empty.
+   */
+  template<typename P, typename F>
+  bool Update(const NodeHandle &base, const P &path, F update) {
+    WriteLock l(mutex_);
+    auto base_node = handles_.Get(base);
+    auto node = base_node ? base_node->FindOrEmplace(path, allocator_) : nullptr;
+    if (!node) return false;
+    update(*node);
+    Changed(node);
+    return true;
+  }
+
+  /**
+   * @brief Stamp a node that was set with a new generation and publish the change. The caller must hold the write lock.
+   * @param node The node.
+   */
+  void Changed(PropertyNode *node) {
+    std::uint64_t generation = NextGeneration();
+    node->Stamp(generation);
+    if (subscriptions_.active()) {
+      Path path;
+      FullPath(node, path);
+      subscriptions_.Publish(PathString(path), ChangeEvent::SET, generation);
+    }
+  }
+
+  /**
+   * @brief Get the node of a handle. The caller must hold the lock.
+   * @param handle The handle.
+   * @return The node, or nullptr if the handle is stale.
+   */
+  PropertyNode *GetHandleNode(const NodeHandle &handle) { return handles_.Get(handle); }
+
+  /**
+   * @brief Get the node at a path, creating the path if necessary. The caller must hold the write lock and stamp a node
+   * it changes with Changed.
+   * @tparam P Path type.
+   * @param path The path.
+   * @return The node, or nullptr if the path is empty.
+   */
+  template<typename P>
+  PropertyNode *AddNode(const P &path) { return root_.FindOrEmplace(path, allocator_); }
+
+  /**
+   * @brief Called under the write lock before a node and its descendants are removed by remove, clear or Apply, for
+   * derived trees that keep resources for their nodes.
+   * @param node The node.
+   */
+  virtual void BeforeRemove(PropertyNode & /*node*/) {}
+
+  /**
+   * @brief Called under the write lock before SetData or Apply replaces the data of a node, for derived trees that
+   * keep resources for the data.
+   * @param node The node.
+   */
+  virtual void BeforeSet(PropertyNode & /*node*/) {}
+
+  /**
+   * @brief Copy the data of a node for GetData, under the read lock. Derived trees that keep the value of a node
+   * elsewhere than in its data load it from there.
+   * @param node The node.
+   * @param data Receives the data.
+   */
+  virtual void LoadData(PropertyNode &node, T &data) { data = node.data(); }
+
+ private:
+  /**
+   * @brief Advance the generation.
+   * @return The new generation.
+   */
+  std::uint64_t NextGeneration() { return ++generation_; }
+
+  /**
+   * @brief Make a handle to a node below the root or below the node of another handle. Nodes created on the way are
+   * stamped with a new generation but not published, as they hold no data yet.
+   * @tparam P Path type.
+   * @param base The handle the path is relative to, nullptr for the root.
+   * @param path The path of the node.
+   * @param create Create the node if it does not exist.
+   * @return The handle, or an empty handle if the base is stale or no node exists at the path.
+   */
+  template<typename P>
+  NodeHandle ResolveBelow(const NodeHandle *base, const P &path, bool create) {
+    {
+      ReadLock l(mutex_);
+      auto *node = base ? handles_.Get(*base) : &root_;
+      auto *p = node ? node->Find(path) : nullptr;
+      if (p && p->handle_slot()) return handles_.Handle(p);
+      if (!node || (!p && !create)) return NodeHandle();
+    }
+    // The first handle to a node changes the table.
+    WriteLock l(mutex_);
+    auto *node = base ? handles_.Get(*base) : &root_;
+    auto *p = node ? node->Find(path) : nullptr;
+    if (!p && node && create) {
+      p = node->FindOrEmplace(path, allocator_);
+      if (p) p->Stamp(NextGeneration());
+    }
+    return p ? handles_.Add(p) : NodeHandle();
+  }
+
+  /**
+   * @brief Append the names of the children of a node. The caller must hold the lock.
+   * @param node The node or nullptr.
+   * @param children_list Receives the names.
+   */
+  static void AppendChildren(PropertyNode *node, std::vector<K> &children_list) {
+    if (!node) return;
+    for (auto j = node->children().begin(); j != node->children().end(); j++) {
+      children_list.push_back(j->first);
+    }
+  }
+
+  /**
+   * @brief Get the full path to a node. The caller must hold the lock.
+   * @param node The node.
+   * @param path Receives the path.
+   */
+  static void FullPath(PropertyNode *node, Path &path) {
+    while (node->parent() != nullptr) {
+      path.push_back(node->name());
+      node = node->parent();
+    }
+    std::reverse(std::begin(path), std::end(path));
+  }
+
 };
 #endif //OBJECT_PROPERTY_TREE_PROPERTY_TREE_H
@@ -0,0 +1,375 @@
+#ifndef OBJECT_PROPERTY_TREE_SMALL_VECTOR_MAP_H
+#define OBJECT_PROPERTY_TREE_SMALL_VECTOR_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "flat_hash_map.h"
+
+/**
+ * @brief A map that keeps up to N entries in a small array sorted by key and searched linearly. Inserting past N
+ * entries moves them all into a FlatHashMap, which is then used until the map is cleared. The array is allocated for the
+ * first entry and grows by doubling up to N, so an empty map is three words and allocates nothing, and a small map makes
+ * one allocation. Small maps iterate in key order; spilled maps iterate in unspecified order.
+ *
+ * Lookups are heterogeneous like those of FlatHashMap. Keys must not be modified through iterators.
+ * @tparam K The key type, it must be ordered by operator<.
+ * @tparam V The mapped type.
+ * @tparam N The number of entries kept in the array.
+ * @tparam Hash The hash function of the spilled map.
+ * @tparam Equal The key equality function.
+ */
+template<typename K, typename V, std::size_t N, typename Hash = NodeKeyHash, typename Equal = NodeKeyEqual>
+class SmallVectorMap {
+ public:
+  typedef K key_type;
+  typedef V mapped_type;
+  typedef std::pair<K, V> value_type;
+  typedef std::size_t size_type;
+  typedef FlatHashMap<K, V, Hash, Equal> SpillMap; ///< The map used beyond N entries.
+
+ private:
+  static_assert(N > 0 && N <= UINT32_MAX, "the array holds 1 to 2^32 - 1 entries");
+  static_assert(alignof(value_type) <= alignof(std::max_align_t), "entries are allocated with operator new");
+
+  value_type *entries_ = nullptr; ///< The array of entries or nullptr, the first size_ are constructed.
+  std::uint32_t size_ = 0; ///< The number of entries in the array.
+  std::uint32_t capacity_ = 0; ///< The number of entries the array has room for.
+  SpillMap *spill_ = nullptr; ///< The spilled entries or nullptr while they fit in the array.
+
+  const SpillMap &spill() const { return *spill_; }
+  value_type *array_begin() { return entries_; }
+  const value_type *array_begin() const { return entries_; }
+
+  /**
+   * @brief Iterates either the array entries or the spilled map.
+   * @tparam Const true for a const iterator.
+   */
+  template<bool Const>
+  class Iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename SmallVectorMap::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<Const, const value_type *, value_type *>::type pointer;
+    typedef typename std::conditional<Const, const value_type &, value_type &>::type reference;
+
+   private:
+    friend class SmallVectorMap;
+    template<bool> friend class Iterator;
+    typedef typename std::conditional<Const, typename SpillMap::const_iterator,
+                                      typename SpillMap::iterator>::type SpillIterator;
+    pointer entry_ = nullptr; ///< The current array entry, nullptr when iterating the spilled map.
+    SpillIterator spill_; ///< The current spilled entry.
+
+    explicit Iterator(pointer entry) : entry_(entry) {}
+    explicit Iterator(SpillIterator spill) : spill_(spill) {}
+
+   public:
+
+    Iterator() = default;
+
+    /**
+     * @brief Convert an iterator to a const iterator.
+     * @param other The iterator to convert.
+     */
+    template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+    Iterator(const Iterator<OtherConst> &other) : entry_(other.entry_), spill_(other.spill_) {}
+
+    reference operator*() const { return entry_ ? *entry_ : *spill_; }
+    pointer operator->() const { return entry_ ? entry_ : &*spill_; }
+
+    Iterator &operator++() {
+      if (entry_) {
+        ++entry_;
+      } else {
+        ++spill_;
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator i = *this;
+      ++*this;
+      return i;
+    }
+
+    template<bool OtherConst>
+    bool operator==(const Iterator<OtherConst> &other) const {
+      return entry_ == other.entry_ && (entry_ || spill_ == other.spill_);
+    }
+
+    template<bool OtherConst>
+    bool operator!=(const Iterator<OtherConst> &other) const { return !(*this == other); }
+  };
+
+ public:
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+
+  /**
+   * @brief Create an empty map.
+   */
+  SmallVectorMap() = default;
+
+  /**
+   * @brief Copy a map.
+   * @param other The map to copy.
+   */
+  SmallVectorMap(const SmallVectorMap &other) {
+    if (other.spill_) {
+      spill_ = new SpillMap(*other.spill_);
+    } else if (other.size_) {
+      Allocate(other.size_);
+      std::uninitialized_copy(other.array_begin(), other.array_begin() + other.size_, array_begin());
+      size_ = other.size_;
+    }
+  }
+
+  /**
+   * @brief Move a map.
+   * @param other The map to move, it is left empty.
+   */
+  SmallVectorMap(SmallVectorMap &&other) noexcept { Swap(other); }
+
+  SmallVectorMap &operator=(const SmallVectorMap &other) {
+    if (this != &other) {
+      SmallVectorMap copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  SmallVectorMap &operator=(SmallVectorMap &&other) noexcept {
+    if (this != &other) {
+      clear();
+      Swap(other);
+    }
+    return *this;
+  }
+
+  ~SmallVectorMap() { clear(); }
+
+  iterator begin() { return spill_ ? iterator(spill_->begin()) : iterator(array_begin()); }
+  iterator end() { return spill_ ? iterator(spill_->end()) : iterator(array_begin() + size_); }
+  const_iterator begin() const { return spill_ ? const_iterator(spill().begin()) : const_iterator(array_begin()); }
+  const_iterator end() const { return spill_ ? const_iterator(spill().end()) : const_iterator(array_begin() + size_); }
+
+  size_type size() const { return spill_ ? spill_->size() : size_; }
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @return true if the entries have been moved to the spilled map.
+   */
+  bool spilled() const { return spill_ != nullptr; }
+
+  /**
+   * @brief Find an entry.
+   * @tparam L The lookup key type.
+   * @param key The key to find.
+   * @return An iterator to the entry or end().
+   */
+  template<typename L>
+  iterator find(const L &key) {
+    if (spill_) return iterator(spill_->find(key));
+    return iterator(array_begin() + FindInArray(key));
+  }
+
+  template<typename L>
+  const_iterator find(const L &key) const {
+    if (spill_) return const_iterator(spill().find(key));
+    return const_iterator(array_begin() + FindInArray(key));
+  }
+
+  /**
+   * @tparam L The lookup key type.
+   * @param key The key to count.
+   * @return 1 if the key is in the map, otherwise 0.
+   */
+  template<typename L>
+  size_type count(const L &key) const { return spill_ ? spill_->count(key) : (FindInArray(key) == size_ ? 0 : 1); }
+
+  /**
+   * @brief Insert an entry if the key is not in the map yet.
+   * @param key The key.
+   * @param value The value.
+   * @return An iterator to the entry with the key and true if it was inserted.
+   */
+  std::pair<iterator, bool> emplace(K key, V value) {
+    if (!spill_) {
+      size_type i = FindInArray(key);
+      if (i != size_) return std::make_pair(iterator(array_begin() + i), false);
+      if (size_ < N) return std::make_pair(iterator(InsertInArray(std::move(key), std::move(value))), true);
+      Spill();
+    }
+    auto result = spill_->emplace(std::move(key), std::move(value));
+    return std::make_pair(iterator(result.first), result.second);
+  }
+
+  /**
+   * @brief Insert an entry if the key is not in the map yet.
+   * @param entry The entry.
+   * @return An iterator to the entry with the key and true if it was inserted.
+   */
+  std::pair<iterator, bool> insert(value_type entry) { return emplace(std::move(entry.first), std::move(entry.second)); }
+
+  /**
+   * @brief Get the value for a key, inserting a default value if the key is not in the map.
+   * @param key The key.
+   * @return A reference to the value.
+   */
+  V &operator[](const K &key) { return emplace(key, V()).first->second; }
+
+  /**
+   * @brief Remove the entry with a key.
+   * @tparam L The lookup key type.
+   * @param key The key to remove.
+   * @return The number of entries removed.
+   */
+  template<typename L>
+  size_type erase(const L &key) {
+    if (spill_) return spill_->erase(key);
+    size_type i = FindInArray(key);
+    if (i == size_) return 0;
+    EraseInArray(i);
+    return 1;
+  }
+
+  /**
+   * @brief Remove an entry. Other iterators are invalidated.
+   * @param position The entry to remove.
+   */
+  void erase(const_iterator position) {
+    if (spill_) {
+      spill_->erase(position.spill_);
+    } else {
+      EraseInArray(static_cast<size_type>(position.entry_ - array_begin()));
+    }
+  }
+
+  void erase(iterator position) { erase(const_iterator(position)); }
+
+  /**
+   * @brief Remove all entries and release the array and the spilled map.
+   */
+  void clear() {
+    Release();
+    delete spill_;
+    spill_ = nullptr;
+  }
+
+ private:
+  /**
+   * @brief Scan the array entries for a key.
+   * @tparam L The lookup key type.
+   * @param key The key.
+   * @return The index of the entry or size_ if it is not in the array.
+   */
+  template<typename L>
+  size_type FindInArray(const L &key) const {
+    const value_type *entries = array_begin();
+    Equal equal;
+    for (size_type i = 0; i < size_; i++) {
+      if (equal(entries[i].first, key)) return i;
+    }
+    return size_;
+  }
+
+  /**
+   * @brief Insert an entry into the sorted array, growing it if it is full. There must be fewer than N entries.
+   * @return The inserted entry.
+   */
+  value_type *InsertInArray(K &&key, V &&value) {
+    if (size_ == capacity_) Grow();
+    value_type *entries = array_begin();
+    size_type i = 0;
+    while (i < size_ && entries[i].first < key) i++;
+    if (i == size_) {
+      new(entries + size_) value_type(std::move(key), std::move(value));
+    } else {
+      new(entries + size_) value_type(std::move(entries[size_ - 1]));
+      std::move_backward(entries + i, entries + size_ - 1, entries + size_);
+      entries[i] = value_type(std::move(key), std::move(value));
+    }
+    size_++;
+    return entries + i;
+  }
+
+  /**
+   * @brief Remove an entry of the array, keeping the array sorted.
+   * @param i The index of the entry.
+   */
+  void EraseInArray(size_type i) {
+    value_type *entries = array_begin();
+    std::move(entries + i + 1, entries + size_, entries + i);
+    entries[size_ - 1].~value_type();
+    size_--;
+  }
+
+  /**
+   * @brief Move the array entries to a new spilled map.
+   */
+  void Spill() {
+    spill_ = new SpillMap();
+    spill_->reserve(N + 1);
+    for (size_type i = 0; i < size_; i++) {
+      value_type &entry = array_begin()[i];
+      spill_->emplace(std::move(entry.first), std::move(entry.second));
+    }
+    Release();
+  }
+
+  /**
+   * @brief Allocate an empty array. The map must not have one.
+   * @param capacity The number of entries it has room for.
+   */
+  void Allocate(std::uint32_t capacity) {
+    entries_ = static_cast<value_type *>(::operator new(capacity * sizeof(value_type)));
+    capacity_ = capacity;
+  }
+
+  /**
+   * @brief Move the entries into an array of twice the capacity, at most N.
+   */
+  void Grow() {
+    value_type *entries = entries_;
+    std::uint32_t size = size_;
+    Allocate(capacity_ ? static_cast<std::uint32_t>(std::min<std::size_t>(2 * capacity_, N)) : 1);
+    for (std::uint32_t i = 0; i < size; i++) {
+      new(entries_ + i) value_type(std::move(entries[i]));
+      entries[i].~value_type();
+    }
+    ::operator delete(entries);
+  }
+
+  /**
+   * @brief Destroy the entries of the array and free it.
+   */
+  void Release() {
+    for (size_type i = 0; i < size_; i++) {
+      array_begin()[i].~value_type();
+    }
+    ::operator delete(entries_);
+    entries_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+  }
+
+  /**
+   * @brief Exchange the storage of two maps.
+   * @param other The other map.
+   */
+  void Swap(SmallVectorMap &other) noexcept {
+    std::swap(entries_, other.entries_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(spill_, other.spill_);
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_SMALL_VECTOR_MAP_H
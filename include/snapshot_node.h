@@ -0,0 +1,90 @@
+#ifndef OBJECT_PROPERTY_TREE_SNAPSHOT_NODE_H
+#define OBJECT_PROPERTY_TREE_SNAPSHOT_NODE_H
+
+#include <memory>
+#include "node_children.h"
+#include "node_key.h"
+
+/**
+ * @brief A node of a SnapshotPropertyTree. Published nodes are immutable and shared between the versions of the tree;
+ * a writer changes a node by copying it, which copies the child map but shares the children themselves.
+ * @tparam K The type of the node name.
+ * @tparam T The type of the node data.
+ * @tparam C The children container policy, see node_children.h.
+ */
+template<typename K, typename T, typename C = MapChildren>
+class SnapshotNode {
+ public:
+  typedef std::shared_ptr<const SnapshotNode> Ptr; ///< A shared published node.
+  typedef typename C::template Container<K, Ptr> ChildMap; ///< map of children, searchable by path segments.
+
+ private:
+  K name_; ///< The name of the node.
+  T data_; ///< The leaf data.
+  ChildMap children_; ///< The children.
+
+ public:
+  /**
+   * @brief Create a node with default data.
+   * @param name The name of the node.
+   */
+  explicit SnapshotNode(const K &name) : name_(name), data_() {}
+
+  /**
+   * @brief Copy a node, sharing its children.
+   * @param other The node to copy.
+   */
+  SnapshotNode(const SnapshotNode &other) = default;
+
+  SnapshotNode &operator=(const SnapshotNode &) = delete;
+
+  /**
+   * @return The name of the node
+   */
+  const K &name() const { return name_; }
+
+  /**
+   * @return reference to the node data.
+   */
+  const T &data() const { return data_; }
+
+  /**
+   * @return The dictionary of children.
+   */
+  const ChildMap &children() const { return children_; }
+
+  /**
+   * @brief Look up a direct child.
+   * @tparam S The segment type, anything comparable with K.
+   * @param segment The name of the child.
+   * @return pointer to the child or nullptr.
+   */
+  template<typename S>
+  const SnapshotNode *FindChild(const S &segment) const {
+    auto i = children_.find(NodeKeyTraits<K>::Lookup(segment));
+    return i == children_.end() ? nullptr : i->second.get();
+  }
+
+  /**
+   * @brief Set the node data value. Only for nodes that have not been published.
+   * @param data The node data to set.
+   */
+  void SetData(const T &data) { data_ = data; }
+
+  /**
+   * @brief Add or replace a child. Only for nodes that have not been published.
+   * @param child The child.
+   */
+  void SetChild(Ptr child) {
+    auto result = children_.emplace(child->name(), child);
+    if (!result.second) result.first->second = std::move(child);
+  }
+
+  /**
+   * @brief Remove a child. Only for nodes that have not been published.
+   * @param child_name The name of the child.
+   */
+  void RemoveChild(const K &child_name) { children_.erase(child_name); }
+};
+
+#endif //OBJECT_PROPERTY_TREE_SNAPSHOT_NODE_H
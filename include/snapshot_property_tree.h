@@ -0,0 +1,319 @@
+#ifndef OBJECT_PROPERTY_TREE_SNAPSHOT_PROPERTY_TREE_H
+#define OBJECT_PROPERTY_TREE_SNAPSHOT_PROPERTY_TREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "compiled_path.h"
+#include "epoch_manager.h"
+#include "node_path.h"
+#include "snapshot_node.h"
+
+/**
+ * @brief A persistent property tree for data that is read all the time and changed rarely. Every change builds a new
+ * version of the tree by copying the nodes on the path to the change and sharing everything else, then publishes its
+ * root atomically. Readers take a Snapshot, which holds one version for as long as they keep it, and read it without
+ * any locking; a snapshot never sees later changes.
+ *
+ * Writers are serialised by one mutex. A change copies depth + 1 nodes, each with its child map.
+ * @tparam K The type of the key.
+ * @tparam T The type of the value.
+ * @tparam C The children container policy of the nodes, see node_children.h.
+ */
+template<typename K, typename T, typename C = MapChildren>
+class SnapshotPropertyTree {
+ public:
+  /**
+   * @brief A node type with matching key and value types.
+   */
+  typedef SnapshotNode<K, T, C> PropertyNode;
+
+  /**
+   * @brief A node path type with matching key type.
+   */
+  typedef NodePath<K> Path;
+
+  /**
+   * @brief A consistent, read-only version of the tree. Snapshots are cheap to copy and keep their version alive.
+   */
+  class Snapshot {
+    typename PropertyNode::Ptr root_; ///< The root of the version.
+    std::uint64_t version_ = 0; ///< The number of the version.
+
+   public:
+    Snapshot() = default;
+
+    /**
+     * @brief Create a snapshot of a version.
+     * @param root The root of the version.
+     * @param version The number of the version.
+     */
+    Snapshot(typename PropertyNode::Ptr root, std::uint64_t version) : root_(std::move(root)), version_(version) {}
+
+    /**
+     * @return The number of the version, it goes up with every change of the tree.
+     */
+    std::uint64_t version() const { return version_; }
+
+    /**
+     * @return The root node or nullptr for an empty snapshot.
+     */
+    const PropertyNode *root() const { return root_.get(); }
+
+    /**
+     * @brief Find a node by path. The node lives as long as the snapshot.
+     * @tparam P Path type.
+     * @param path The path of the node to get.
+     * @return A pointer to the node at the path or nullptr is a node doesn't exist at that path.
+     */
+    template<typename P>
+    const PropertyNode *Find(const P &path) const {
+      auto &&segments = PathSegments(path);
+      auto segment = segments.begin();
+      auto end = segments.end();
+      if (segment == end) return nullptr;
+      const PropertyNode *node = root_.get();
+      for (; node && segment != end; ++segment) {
+        node = node->FindChild(*segment);
+      }
+      return node;
+    }
+
+    /**
+     * @brief Get a copy of the data at a path.
+     * @tparam P Path type.
+     * @param path The path of the object to get.
+     * @param data A reference to collect the data object.
+     * @return true if a node exists at path.
+     */
+    template<typename P>
+    bool GetData(const P &path, T &data) const {
+      const PropertyNode *node = Find(path);
+      if (!node) return false;
+      data = node->data();
+      return true;
+    }
+
+    /**
+     * @brief Check if a node exists at the path.
+     * @tparam P Path type.
+     * @param path The path of the check.
+     * @return true if a node exists at path.
+     */
+    template<typename P>
+    bool exists(const P &path) const { return Find(path) != nullptr; }
+
+    /**
+     * @brief List the children of a node
+     * @tparam P The path type.
+     * @param path The path of the node to list.
+     * @param children_list receives the list of child node names.
+     * @param sorted Sort the names. Only needed for children containers that are not ordered.
+     * @return The length of the list.
+     */
+    template<typename P>
+    unsigned long ListChildren(const P &path, std::vector<K> &children_list, bool sorted = false) const {
+      return List(Find(path), children_list, sorted);
+    }
+
+    /**
+     * @brief List the children of the root node
+     * @param children_list receives the list of child node names.
+     * @param sorted Sort the names. Only needed for children containers that are not ordered.
+     * @return The length of the list.
+     */
+    unsigned long ListChildren(std::vector<K> &children_list, bool sorted = false) const {
+      return List(root_.get(), children_list, sorted);
+    }
+
+   private:
+    /**
+     * @brief List the children of a node.
+     * @param node The node or nullptr.
+     * @param children_list receives the list of child node names.
+     * @param sorted Sort the names.
+     * @return The length of the list.
+     */
+    static unsigned long List(const PropertyNode *node, std::vector<K> &children_list, bool sorted) {
+      children_list.clear();
+      if (node) {
+        for (auto i = node->children().begin(); i != node->children().end(); i++) {
+          children_list.push_back(i->first);
+        }
+      }
+      if (sorted && !C::ordered) std::sort(children_list.begin(), children_list.end());
+      return children_list.size();
+    }
+  };
+
+ private:
+  /**
+   * @brief A published version of the tree.
+   */
+  struct Version {
+    typename PropertyNode::Ptr root; ///< The root node.
+    std::uint64_t number; ///< The number of the version.
+  };
+
+  std::mutex write_mutex_; ///< Serialises the writers.
+  std::atomic<const Version *> current_; ///< The latest version, old versions are retired to the EpochManager.
+  std::atomic<bool> changed_{false}; ///< Track if any action may have changed the tree.
+
+ public:
+  /**
+   * @brief Create a property tree.
+   */
+  SnapshotPropertyTree()
+      : current_(new Version{std::make_shared<PropertyNode>(NodeKeyTraits<K>::Make("__ROOT__")), 0}) {}
+
+  SnapshotPropertyTree(const SnapshotPropertyTree &) = delete;
+  SnapshotPropertyTree &operator=(const SnapshotPropertyTree &) = delete;
+
+  /**
+   * @brief Delete the property tree. Snapshots taken from it stay valid.
+   */
+  virtual ~SnapshotPropertyTree() { delete current_.load(); }
+
+  /**
+   * @return The changed flag. True if something has changed.
+   */
+  bool changed() const { return changed_; }
+
+  /**
+   * @brief Set changed to false.
+   */
+  void ClearChanged() { changed_ = false; }
+
+  /**
+   * @brief Set the changed flag. Default is true.
+   * @param changed The flag to set.
+   */
+  void SetChanged(bool changed = true) { changed_ = changed; }
+
+  /**
+   * @brief Take a snapshot of the latest version. No lock is taken, the version is read under an epoch.
+   * @return The snapshot.
+   */
+  Snapshot snapshot() const {
+    EpochManager::Guard guard;
+    const Version *current = current_.load(std::memory_order_acquire);
+    return Snapshot(current->root, current->number);
+  }
+
+  /**
+   * @brief Get a copy of the data at a path in the latest version.
+   * @tparam P Path type.
+   * @param path The path of the object to get.
+   * @param data A reference to collect the data object.
+   * @return true if a node exists at path.
+   */
+  template<typename P>
+  bool GetData(const P &path, T &data) const { return snapshot().GetData(path, data); }
+
+  /**
+   * @brief Check if a node exists at the path in the latest version.
+   * @tparam P Path type.
+   * @param path The path of the check.
+   * @return true if a node exists at path.
+   */
+  template<typename P>
+  bool exists(const P &path) const { return snapshot().exists(path); }
+
+  /**
+   * @brief Set data for a node in a new version. Path is created if necessary.
+   * @tparam P Path type.
+   * @param path The path of the node to set.
+   * @param data The data to set at path.
+   */
+  template<typename P>
+  void SetData(const P &path, const T &data) {
+    std::lock_guard<std::mutex> l(write_mutex_);
+    std::vector<const PropertyNode *> chain;
+    std::vector<K> names;
+    if (!Walk(path, chain, names)) return;
+    auto leaf = chain.back() ? std::make_shared<PropertyNode>(*chain.back())
+                             : std::make_shared<PropertyNode>(names.back());
+    leaf->SetData(data);
+    Publish(Replace(chain, names, std::move(leaf)));
+  }
+
+  /**
+   * @brief Remove the node at path in a new version. Snapshots that contain the node keep it.
+   * @tparam P Path type.
+   * @param path The path of the node to remove.
+   */
+  template<typename P>
+  void remove(const P &path) {
+    std::lock_guard<std::mutex> l(write_mutex_);
+    std::vector<const PropertyNode *> chain;
+    std::vector<K> names;
+    if (!Walk(path, chain, names) || !chain.back()) return;
+    Publish(Replace(chain, names, nullptr));
+  }
+
+  /**
+   * @brief Clear / delete all nodes (other than root) in a new version.
+   */
+  void clear() {
+    std::lock_guard<std::mutex> l(write_mutex_);
+    Publish(std::make_shared<PropertyNode>(NodeKeyTraits<K>::Make("__ROOT__")));
+  }
+
+ private:
+  /**
+   * @brief Collect the nodes of the latest version along a path. The write mutex must be held.
+   * @tparam P Path type.
+   * @param path The path.
+   * @param chain Receives the root followed by the node at each segment, nullptr from the first missing one on.
+   * @param names Receives the name of each segment.
+   * @return false if the path is empty.
+   */
+  template<typename P>
+  bool Walk(const P &path, std::vector<const PropertyNode *> &chain, std::vector<K> &names) const {
+    const PropertyNode *node = current_.load(std::memory_order_relaxed)->root.get();
+    chain.push_back(node);
+    for (auto &&segment : PathSegments(path)) {
+      node = node ? node->FindChild(segment) : nullptr;
+      chain.push_back(node);
+      names.push_back(node ? node->name() : NodeKeyTraits<K>::Make(segment));
+    }
+    return !names.empty();
+  }
+
+  /**
+   * @brief Copy the nodes above the end of a chain with its last node replaced.
+   * @param chain The nodes along the path, see Walk.
+   * @param names The names of the segments.
+   * @param node The replacement for the last node, nullptr to remove it.
+   * @return The new root.
+   */
+  static typename PropertyNode::Ptr Replace(const std::vector<const PropertyNode *> &chain,
+                                            const std::vector<K> &names, typename PropertyNode::Ptr node) {
+    for (std::size_t i = names.size(); i-- > 0;) {
+      auto parent = chain[i] ? std::make_shared<PropertyNode>(*chain[i]) : std::make_shared<PropertyNode>(names[i - 1]);
+      if (node) {
+        parent->SetChild(std::move(node));
+      } else {
+        parent->RemoveChild(names[i]);
+      }
+      node = std::move(parent);
+    }
+    return node;
+  }
+
+  /**
+   * @brief Make a root the latest version. The write mutex must be held.
+   * @param root The new root.
+   */
+  void Publish(typename PropertyNode::Ptr root) {
+    const Version *previous = current_.load(std::memory_order_relaxed);
+    current_.store(new Version{std::move(root), previous->number + 1}, std::memory_order_release);
+    EpochManager::Global().Retire(previous);
+    SetChanged();
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_SNAPSHOT_PROPERTY_TREE_H
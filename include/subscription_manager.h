@@ -0,0 +1,187 @@
+#ifndef OBJECT_PROPERTY_TREE_SUBSCRIPTION_MANAGER_H
+#define OBJECT_PROPERTY_TREE_SUBSCRIPTION_MANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "compiled_path.h"
+#include "node_path.h"
+
+/**
+ * @brief A change to a property tree, as delivered to subscribers.
+ */
+struct ChangeEvent {
+  /**
+   * @brief The kind of change.
+   */
+  enum Kind {
+    SET, ///< Data was set at the path.
+    REMOVED ///< The node at the path and its descendants were removed. The root path "" means the tree was cleared.
+  };
+
+  std::string path; ///< The path of the changed node, segments joined with the default separator.
+  Kind kind; ///< The kind of change.
+  std::uint64_t generation; ///< The generation of the tree after the change.
+};
+
+/**
+ * @brief Delivers the changes of a property tree to subscribers. Subscribers register a pattern whose segments are
+ * names or "*" for any one segment. A subscription receives the changes at the paths the pattern matches and below
+ * them, and the removals of nodes above them.
+ *
+ * Publishing only records the change; a dispatcher thread, started by the first Subscribe, calls the subscribers with
+ * batches of changes. Changes to the same path that are waiting for delivery are coalesced, only the latest is
+ * delivered, so a burst of updates to a leaf becomes a single event. The dispatcher waits for the batch delay after
+ * the first change of a batch to let bursts collect. Without subscriptions publishers only load an atomic counter, see
+ * active().
+ */
+class SubscriptionManager {
+ public:
+  /**
+   * @brief Called on the dispatcher thread with a batch of changes, in the order they were made.
+   */
+  typedef std::function<void(const std::vector<ChangeEvent> &)> Callback;
+
+  /**
+   * @brief Create a manager. No thread is started until the first Subscribe.
+   * @param delay The batch delay.
+   */
+  explicit SubscriptionManager(std::chrono::milliseconds delay = std::chrono::milliseconds(1)) : delay_(delay) {}
+
+  SubscriptionManager(const SubscriptionManager &) = delete;
+  SubscriptionManager &operator=(const SubscriptionManager &) = delete;
+
+  /**
+   * @brief Stop the dispatcher. Changes not delivered yet are dropped.
+   */
+  ~SubscriptionManager();
+
+  /**
+   * @brief Stop the dispatcher and wait for a batch that is being delivered. Changes not delivered yet are dropped, and
+   * nothing is delivered afterwards. Must not be called from a callback.
+   */
+  void Stop();
+
+  /**
+   * @brief Register interest in a path pattern.
+   * @param pattern The pattern, e.g. "sensors.*.value".
+   * @param callback Called with the batches of matching changes.
+   * @return The id of the subscription.
+   */
+  std::size_t Subscribe(boost::string_view pattern, Callback callback);
+
+  /**
+   * @brief Cancel a subscription. A batch that is being delivered to it may still complete.
+   * @param id The id of the subscription.
+   */
+  void Unsubscribe(std::size_t id);
+
+  /**
+   * @return true if there are subscriptions. This is all publishers should pay while there are none.
+   */
+  bool active() const { return subscriptions_count_.load(std::memory_order_relaxed) != 0; }
+
+  /**
+   * @brief Record a change for the subscriptions that match it.
+   * @param path The path of the change, see PathString.
+   * @param kind The kind of change.
+   * @param generation The generation of the tree after the change.
+   */
+  void Publish(const std::string &path, ChangeEvent::Kind kind, std::uint64_t generation);
+
+  /**
+   * @brief Record several changes at once, a batch being delivered never contains only some of them.
+   * @param events The changes.
+   */
+  void Publish(const std::vector<ChangeEvent> &events);
+
+  /**
+   * @brief Deliver the recorded changes now, without the batch delay, and wait until they have been delivered. Must
+   * not be called from a callback.
+   */
+  void Flush();
+
+ private:
+  /**
+   * @brief A subscription and the changes waiting for it.
+   */
+  struct Subscription {
+    std::vector<std::string> pattern; ///< The pattern segments.
+    Callback callback; ///< The subscriber.
+    /// The latest change per path with its record number, guarded by mutex_.
+    std::map<std::string, std::pair<std::uint64_t, ChangeEvent>> pending;
+  };
+
+  std::chrono::milliseconds delay_; ///< The batch delay.
+  std::atomic<std::size_t> subscriptions_count_{0}; ///< The number of subscriptions, read by active().
+  std::mutex mutex_; ///< Guards the members below.
+  std::condition_variable wake_; ///< Wakes the dispatcher.
+  std::condition_variable idle_; ///< Signalled when the dispatcher has delivered everything.
+  std::map<std::size_t, std::shared_ptr<Subscription>> subscriptions_; ///< The subscriptions by id.
+  std::size_t next_id_ = 1; ///< The id of the next subscription.
+  std::uint64_t recorded_ = 0; ///< The number of changes recorded, orders the changes of a batch.
+  bool pending_ = false; ///< There are changes waiting for delivery.
+  bool delivering_ = false; ///< The dispatcher is calling subscribers.
+  bool flushing_ = false; ///< A Flush is waiting, skip the batch delay.
+  bool stopping_ = false; ///< The manager is being destroyed.
+  std::thread dispatcher_; ///< The dispatcher thread, started by the first Subscribe.
+
+  /**
+   * @brief Record a change for the subscriptions that match it. mutex_ must be held.
+   * @param event The change.
+   * @return true if the dispatcher must be woken.
+   */
+  bool Record(const ChangeEvent &event);
+
+  /**
+   * @brief The dispatcher thread.
+   */
+  void Run();
+
+  /**
+   * @brief Check if a change concerns a pattern.
+   * @param pattern The pattern segments.
+   * @param path The path of the change.
+   * @param kind The kind of change.
+   * @return true if the path matches the pattern or is below it, or is above it and was removed.
+   */
+  static bool Matches(const std::vector<std::string> &pattern, boost::string_view path, ChangeEvent::Kind kind);
+};
+
+/**
+ * @brief Append a path segment to a string.
+ * @param string The string.
+ * @param segment The segment.
+ */
+inline void AppendSegment(std::string &string, boost::string_view segment) {
+  string.append(segment.data(), segment.size());
+}
+
+inline void AppendSegment(std::string &string, const KeyAtom &segment) { string += segment.str(); }
+
+/**
+ * @brief Get the canonical string of any path type: its segments joined with the default separator.
+ * @tparam P Path type.
+ * @param path The path.
+ * @return The string.
+ */
+template<typename P>
+std::string PathString(const P &path) {
+  std::string string;
+  for (auto &&segment : PathSegments(path)) {
+    if (!string.empty()) string += DEFAULT_SEPARATOR;
+    AppendSegment(string, segment);
+  }
+  return string;
+}
+
+#endif //OBJECT_PROPERTY_TREE_SUBSCRIPTION_MANAGER_H
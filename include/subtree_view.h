@@ -0,0 +1,133 @@
+#ifndef OBJECT_PROPERTY_TREE_SUBTREE_VIEW_H
+#define OBJECT_PROPERTY_TREE_SUBTREE_VIEW_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "object_property_tree.h"
+
+/**
+ * @brief A cursor on one node of an object property tree, e.g. "tenants.acme", with the object API of the tree for
+ * paths relative to that node. The node is held by a NodeHandle, so each call takes the tree lock once, finds the node
+ * without walking the prefix and walks only the relative path. Reads take the read lock and writes the write lock,
+ * as with the tree.
+ *
+ * Once the node is removed the view is stale: gets return nothing and sets fail, even if the prefix is created again.
+ */
+class SubtreeView {
+  ObjectPropertyTree *tree_ = nullptr; ///< The tree.
+  NodeHandle handle_; ///< The handle of the node.
+
+ public:
+  /**
+   * @brief Create an empty view.
+   */
+  SubtreeView() = default;
+
+  /**
+   * @brief Create a view on the node of a handle.
+   * @param tree The tree.
+   * @param handle The handle, see ObjectPropertyTree::Resolve.
+   */
+  SubtreeView(ObjectPropertyTree &tree, const NodeHandle &handle) : tree_(&tree), handle_(handle) {}
+
+  /**
+   * @brief Create a view on the node at a path, creating the node if it does not exist.
+   * @tparam P Path type.
+   * @param tree The tree.
+   * @param path The path of the node.
+   */
+  template<typename P>
+  SubtreeView(ObjectPropertyTree &tree, const P &path) : tree_(&tree), handle_(tree.Resolve(path, true)) {}
+
+  /**
+   * @return The handle of the node.
+   */
+  const NodeHandle &handle() const { return handle_; }
+
+  /**
+   * @return true if the node still exists.
+   */
+  bool exists() const { return tree_ && tree_->exists(handle_); }
+
+  /**
+   * @brief Create a view on a node below this one, creating the node if it does not exist.
+   * @tparam P Path type.
+   * @param path The path relative to this node.
+   * @return The view, empty if this view is stale or the path is empty.
+   */
+  template<typename P>
+  SubtreeView View(const P &path) const {
+    return tree_ ? SubtreeView(*tree_, tree_->Resolve(handle_, path, true)) : SubtreeView();
+  }
+
+  /**
+   * @brief Set an object at a relative path, creating the path if necessary.
+   * @tparam P Path type.
+   * @tparam T The type of the object.
+   * @param path The path relative to this node.
+   * @param object The object, moved if it is an rvalue.
+   * @return false if the view is stale, the path is empty or the leaf is atomic and the object is not a number.
+   */
+  template<typename P, typename T>
+  bool SetObject(const P &path, T &&object) {
+    return tree_ && tree_->SetObject(handle_, path, std::forward<T>(object));
+  }
+
+  /**
+   * @brief Get the object at a relative path.
+   * @tparam T The type of the object to get.
+   * @tparam P Path type.
+   * @param path The path relative to this node.
+   * @return The object, a new object if there is none or the view is stale.
+   */
+  template<typename T, typename P>
+  T GetObject(const P &path) {
+    return tree_ ? tree_->GetObject<T>(handle_, path) : T();
+  }
+
+  /**
+   * @brief Get the pointer of the object stored at a relative path.
+   * @tparam T The type of the stored object.
+   * @tparam P Path type.
+   * @param path The path relative to this node.
+   * @return A pointer to the object, nullptr if there is none or the view is stale.
+   */
+  template<typename T, typename P>
+  T *GetPointer(const P &path) {
+    return tree_ ? tree_->GetPointer<T>(handle_, path) : nullptr;
+  }
+
+  /**
+   * @brief List the children of a node at a relative path.
+   * @tparam P Path type.
+   * @param path The path relative to this node.
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list.
+   */
+  template<typename P>
+  unsigned long ListChildren(const P &path, std::vector<std::string> &children_list, bool sorted = false) {
+    if (!tree_) {
+      children_list.clear();
+      return 0;
+    }
+    return tree_->ListChildren(handle_, path, children_list, sorted);
+  }
+
+  /**
+   * @brief List the children of this node.
+   * @param children_list receives the list of child node names.
+   * @param sorted Sort the names. Only needed for children containers that are not ordered.
+   * @return The length of the list.
+   */
+  unsigned long ListChildren(std::vector<std::string> &children_list, bool sorted = false) {
+    if (!tree_) {
+      children_list.clear();
+      return 0;
+    }
+    return tree_->ListChildren(handle_, children_list, sorted);
+  }
+};
+
+#endif //OBJECT_PROPERTY_TREE_SUBTREE_VIEW_H
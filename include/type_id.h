@@ -0,0 +1,77 @@
+#ifndef OBJECT_PROPERTY_TREE_TYPE_ID_H
+#define OBJECT_PROPERTY_TREE_TYPE_ID_H
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <boost/utility/string_view.hpp>
+
+/**
+ * @brief The identity of a type without RTTI. Each type has one static record and its id is the address of that record,
+ * so comparing ids is a single pointer compare, ids never collide and they work in builds with -fno-rtti. Const and
+ * reference qualifiers are ignored.
+ */
+class TypeId {
+  /**
+   * @brief The static record of a type.
+   */
+  struct Info {
+    boost::string_view (*name)(); ///< Get the name of the type.
+  };
+
+  /**
+   * @brief The record of a type.
+   * @tparam T The type.
+   */
+  template<typename T>
+  struct InfoFor {
+    static const Info info;
+
+    /**
+     * @return The name of T, taken from the signature of this function as the compiler prints it.
+     */
+    static boost::string_view Name() {
+      boost::string_view signature = __PRETTY_FUNCTION__;
+      std::size_t start = signature.find("T = ");
+      if (start == boost::string_view::npos) return signature;
+      start += 4;
+      std::size_t end = signature.find(';', start);
+      if (end == boost::string_view::npos) end = signature.rfind(']');
+      return signature.substr(start, end - start);
+    }
+  };
+
+  const Info *info_; ///< The record of the type.
+
+  constexpr explicit TypeId(const Info *info) : info_(info) {}
+
+ public:
+  /**
+   * @brief Get the id of a type.
+   * @tparam T The type.
+   * @return The id.
+   */
+  template<typename T>
+  static constexpr TypeId Of() {
+    return TypeId(&InfoFor<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::info);
+  }
+
+  /**
+   * @return The name of the type as the compiler spells it, for diagnostics only.
+   */
+  boost::string_view name() const { return info_->name(); }
+
+  /**
+   * @return A hash of the id.
+   */
+  std::size_t hash() const { return std::hash<const void *>()(info_); }
+
+  constexpr bool operator==(const TypeId &other) const { return info_ == other.info_; }
+  constexpr bool operator!=(const TypeId &other) const { return info_ != other.info_; }
+  bool operator<(const TypeId &other) const { return std::less<const Info *>()(info_, other.info_); }
+};
+
+template<typename T>
+const TypeId::Info TypeId::InfoFor<T>::info = {&TypeId::InfoFor<T>::Name};
+
+#endif //OBJECT_PROPERTY_TREE_TYPE_ID_H
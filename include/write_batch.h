@@ -0,0 +1,145 @@
+#ifndef OBJECT_PROPERTY_TREE_WRITE_BATCH_H
+#define OBJECT_PROPERTY_TREE_WRITE_BATCH_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "node_path.h"
+#include "subscription_manager.h"
+
+/**
+ * @brief A list of set and remove operations to apply to a PropertyTree at once, see PropertyTree::Apply. The paths
+ * are stored back to back in one buffer in canonical form, segments joined with the default separator, so adding an
+ * operation does not allocate once the batch has grown and equal paths compare equal.
+ * @tparam K The type of the key.
+ * @tparam T The type of the value.
+ */
+template<typename K, typename T>
+class WriteBatch {
+ public:
+  /**
+   * @brief One operation of the batch.
+   */
+  struct Operation {
+    std::size_t offset; ///< The start of the path in the buffer.
+    std::size_t size; ///< The length of the path.
+    bool remove; ///< true to remove the node, false to set its data.
+    T data; ///< The data to set.
+  };
+
+ private:
+  std::string paths_; ///< The paths of the operations.
+  std::vector<Operation> operations_; ///< The operations in the order they were added.
+
+ public:
+  /**
+   * @brief Add an operation that sets data for a node. Path is created if necessary.
+   * @tparam P Path type.
+   * @param path The path of the node to set.
+   * @param data The data to set at path.
+   * @return This batch.
+   */
+  template<typename P>
+  WriteBatch &Set(const P &path, T data) {
+    std::size_t offset = Append(path);
+    operations_.push_back(Operation{offset, paths_.size() - offset, false, std::move(data)});
+    return *this;
+  }
+
+  /**
+   * @brief Add an operation that removes a node.
+   * @tparam P Path type.
+   * @param path The path of the node to remove.
+   * @return This batch.
+   */
+  template<typename P>
+  WriteBatch &Remove(const P &path) {
+    std::size_t offset = Append(path);
+    operations_.push_back(Operation{offset, paths_.size() - offset, true, T()});
+    return *this;
+  }
+
+  /**
+   * @return The operations in the order they were added.
+   */
+  const std::vector<Operation> &operations() const { return operations_; }
+
+  /**
+   * @param operation An operation of this batch.
+   * @return The canonical path of the operation.
+   */
+  boost::string_view path(const Operation &operation) const {
+    return boost::string_view(paths_).substr(operation.offset, operation.size);
+  }
+
+  /**
+   * @return The number of operations.
+   */
+  std::size_t size() const { return operations_.size(); }
+
+  /**
+   * @return true if there are no operations.
+   */
+  bool empty() const { return operations_.empty(); }
+
+  /**
+   * @brief Remove all operations, keeping the memory for the next batch.
+   */
+  void clear() {
+    paths_.clear();
+    operations_.clear();
+  }
+
+  /**
+   * @brief Reserve room for operations.
+   * @param count The number of operations.
+   * @param path_size The expected length of their paths.
+   */
+  void reserve(std::size_t count, std::size_t path_size = 32) {
+    operations_.reserve(count);
+    paths_.reserve(count * path_size);
+  }
+
+ private:
+  /**
+   * @brief Append the canonical form of a path to the buffer.
+   * @tparam P Path type.
+   * @param path The path.
+   * @return The offset of the path in the buffer.
+   */
+  template<typename P>
+  std::size_t Append(const P &path) {
+    std::size_t offset = paths_.size();
+    for (auto &&segment : PathSegments(path)) {
+      if (paths_.size() != offset) paths_ += DEFAULT_SEPARATOR;
+      AppendSegment(paths_, segment);
+    }
+    return offset;
+  }
+
+  /**
+   * @brief Append the canonical form of a string path to the buffer, copying it whole if it has no empty segments.
+   * @param path The path.
+   * @return The offset of the path in the buffer.
+   */
+  std::size_t Append(boost::string_view path) {
+    const char separator = DEFAULT_SEPARATOR[0];
+    char doubled[] = {separator, separator};
+    if (path.empty() || path.front() == separator || path.back() == separator
+        || path.find(boost::string_view(doubled, 2)) != boost::string_view::npos) {
+      return Append(PathTokenizer(path));
+    }
+    std::size_t offset = paths_.size();
+    paths_.append(path.data(), path.size());
+    return offset;
+  }
+
+  /**
+   * @brief Append the canonical form of a string path to the buffer.
+   * @param path The path.
+   * @return The offset of the path in the buffer.
+   */
+  std::size_t Append(const std::string &path) { return Append(boost::string_view(path)); }
+};
+
+#endif //OBJECT_PROPERTY_TREE_WRITE_BATCH_H
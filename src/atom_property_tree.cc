@@ -0,0 +1 @@
+#include "atom_property_tree.h"
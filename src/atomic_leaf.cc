@@ -0,0 +1 @@
+#include "atomic_leaf.h"
@@ -0,0 +1,33 @@
+#include "catch.hpp"
+#include "object_property_tree.h"
+
+TEST_CASE("Atomic leaf updates") {
+  ObjectPropertyTree object_tree;
+  std::vector<std::string> paths;
+  for (int i = 0; i < 100; i++) {
+    paths.push_back("service.endpoint" + std::to_string(i) + ".requests");
+    object_tree.SetObject(paths.back(), std::int64_t(0));
+  }
+
+  BENCHMARK("SetObject per update") {
+    for (int i = 0; i < 1000; i++) {
+      for (auto &path : paths) {
+        object_tree.SetObject(path, std::int64_t(i));
+      }
+    }
+  }
+
+  std::vector<AtomicLeaf<std::int64_t>> counters;
+  for (auto &path : paths) {
+    counters.push_back(object_tree.GetAtomic<std::int64_t>(path));
+  }
+  BENCHMARK("fetch_add on atomic leaf handles") {
+    for (int i = 0; i < 1000; i++) {
+      for (auto &counter : counters) {
+        counter.fetch_add(1);
+      }
+    }
+  }
+
+  REQUIRE(object_tree.GetObject<std::int64_t>(paths.front()) == 999 + 1000);
+}
@@ -0,0 +1,32 @@
+#include "catch.hpp"
+#include "object_property_tree.h"
+
+TEST_CASE("CompiledPath lookups") {
+  ObjectPropertyTree object_tree;
+  std::vector<std::string> paths;
+  std::vector<CompiledPath> compiled_paths;
+
+  // 512 leaves eight levels deep.
+  for (int i = 0; i < 512; i++) {
+    std::string path = "plant.area" + std::to_string(i % 4) + ".unit" + std::to_string(i % 16) + ".device"
+        + std::to_string(i % 32) + ".sensor" + std::to_string(i) + ".config.value.current";
+    object_tree.SetObject(path, i);
+    paths.push_back(path);
+    compiled_paths.emplace_back(path);
+  }
+
+  long sum = 0;
+  BENCHMARK("string path lookups") {
+    for (auto &path : paths) {
+      sum += object_tree.GetObject<int>(path);
+    }
+  }
+
+  BENCHMARK("compiled path lookups") {
+    for (auto &path : compiled_paths) {
+      sum += object_tree.GetObject<int>(path);
+    }
+  }
+
+  REQUIRE(sum > 0);
+}
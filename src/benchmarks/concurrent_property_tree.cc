@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "concurrent_property_tree.h"
+#include "property_tree.h"
+#include <boost/thread.hpp>
+
+namespace {
+/**
+ * @brief Run readers of one subtree against a writer of another and wait for them.
+ * @tparam Tree The tree type.
+ * @param tree The tree.
+ * @param readers The number of reader threads.
+ * @param config The paths the readers read.
+ * @param sensors The paths the writer updates.
+ */
+template<typename Tree>
+void ReadWhileWriting(Tree &tree, int readers, const std::vector<CompiledPath> &config,
+                      const std::vector<CompiledPath> &sensors) {
+  boost::thread_group threads;
+  threads.create_thread([&tree, &sensors]() {
+    for (int i = 0; i < 20; i++) {
+      for (auto &path : sensors) {
+        tree.SetData(path, i);
+      }
+    }
+  });
+  for (int r = 0; r < readers; r++) {
+    threads.create_thread([&tree, &config]() {
+      int data = 0;
+      for (int i = 0; i < 20; i++) {
+        for (auto &path : config) {
+          tree.GetData(path, data);
+        }
+      }
+    });
+  }
+  threads.join_all();
+}
+
+/**
+ * @brief Fill a tree with the config and sensor paths.
+ * @tparam Tree The tree type.
+ * @param tree The tree.
+ * @param config The config paths.
+ * @param sensors The sensor paths.
+ */
+template<typename Tree>
+void Fill(Tree &tree, const std::vector<CompiledPath> &config, const std::vector<CompiledPath> &sensors) {
+  for (auto &path : config) tree.SetData(path, 1);
+  for (auto &path : sensors) tree.SetData(path, 1);
+}
+}
+
+TEST_CASE("Tree lock contention") {
+  std::vector<CompiledPath> config;
+  std::vector<CompiledPath> sensors;
+  for (int i = 0; i < 5000; i++) {
+    config.emplace_back("config.unit" + std::to_string(i % 50) + ".setting" + std::to_string(i));
+    sensors.emplace_back("sensors.unit" + std::to_string(i % 50) + ".sensor" + std::to_string(i) + ".value");
+  }
+
+  PropertyTree<std::string, int> global;
+  ConcurrentPropertyTree<std::string, int> concurrent;
+  Fill(global, config, sensors);
+  Fill(concurrent, config, sensors);
+
+  for (int readers : {1, 2, 4, 8}) {
+    BENCHMARK("tree-wide lock, 1 writer and " + std::to_string(readers) + " readers") {
+      ReadWhileWriting(global, readers, config, sensors);
+    }
+    BENCHMARK("per-node locks, 1 writer and " + std::to_string(readers) + " readers") {
+      ReadWhileWriting(concurrent, readers, config, sensors);
+    }
+  }
+
+  REQUIRE(concurrent.exists("sensors.unit0.sensor0.value"));
+}
@@ -0,0 +1,61 @@
+#include "catch.hpp"
+#include "epoch_property_tree.h"
+#include "property_tree.h"
+#include <boost/thread.hpp>
+
+namespace {
+/**
+ * @brief Read every path from several threads and wait for them.
+ * @tparam Tree The tree type.
+ * @param tree The tree.
+ * @param readers The number of reader threads.
+ * @param paths The paths to read.
+ * @return The sum of the data read.
+ */
+template<typename Tree>
+long ReadAll(Tree &tree, int readers, const std::vector<CompiledPath> &paths) {
+  std::atomic<long> sum(0);
+  boost::thread_group threads;
+  for (int r = 0; r < readers; r++) {
+    threads.create_thread([&tree, &paths, &sum]() {
+      long local = 0;
+      int data = 0;
+      for (int i = 0; i < 10; i++) {
+        for (auto &path : paths) {
+          tree.GetData(path, data);
+          local += data;
+        }
+      }
+      sum += local;
+    });
+  }
+  threads.join_all();
+  return sum;
+}
+}
+
+TEST_CASE("Lock-free reads") {
+  std::vector<CompiledPath> paths;
+  for (int i = 0; i < 20000; i++) {
+    paths.emplace_back("config.unit" + std::to_string(i % 100) + ".setting" + std::to_string(i));
+  }
+
+  PropertyTree<std::string, int> locked;
+  EpochPropertyTree<std::string, int> epoch;
+  for (auto &path : paths) {
+    locked.SetData(path, 1);
+    epoch.SetData(path, 1);
+  }
+
+  long sum = 0;
+  for (int readers : {1, 4}) {
+    BENCHMARK("shared_mutex reads, " + std::to_string(readers) + " readers") {
+      sum += ReadAll(locked, readers, paths);
+    }
+    BENCHMARK("epoch reads, " + std::to_string(readers) + " readers") {
+      sum += ReadAll(epoch, readers, paths);
+    }
+  }
+
+  REQUIRE(sum == 2 * 10 * 5 * static_cast<long>(paths.size()));
+}
@@ -0,0 +1,53 @@
+#include "catch.hpp"
+#include "object_property_tree.h"
+
+/**
+ * @brief Build a plant of 100 units with 10000 double sensors each.
+ * @param object_tree The tree.
+ */
+static void BuildPlant(ObjectPropertyTree &object_tree) {
+  for (int unit = 0; unit < 100; unit++) {
+    for (int sensor = 0; sensor < 10000; sensor++) {
+      object_tree.SetObject("plant.unit" + std::to_string(unit) + ".sensor" + std::to_string(sensor) + ".value",
+                            static_cast<double>(sensor));
+    }
+  }
+}
+
+/**
+ * @brief Sum the double leaves below a node by visiting the nodes.
+ */
+static double SumNodes(ObjectPropertyTree &object_tree, ObjectNode *node) {
+  double sum = object_tree.GetObject<double>(node);
+  for (auto &child : node->children()) {
+    sum += SumNodes(object_tree, child.second);
+  }
+  return sum;
+}
+
+TEST_CASE("Leaf column summaries") {
+  ObjectPropertyTree nodes;
+  BuildPlant(nodes);
+  ObjectPropertyTree columns;
+  columns.RegisterColumn<double>();
+  BuildPlant(columns);
+
+  double node_sum = 0;
+  BENCHMARK("Sum of 1M leaves visiting the nodes") {
+    ReadLock l(nodes.mutex());
+    node_sum = SumNodes(nodes, nodes.GetRootNode().Find("plant"));
+  }
+
+  double column_sum = 0;
+  BENCHMARK("Sum of 1M leaves in a column, first summary") {
+    column_sum = columns.Summarize<double>("plant").sum;
+  }
+
+  BENCHMARK("Sum of 1M leaves in a column, cached slots") {
+    for (int i = 0; i < 10; i++) {
+      column_sum = columns.Summarize<double>("plant").sum;
+    }
+  }
+
+  REQUIRE(node_sum == column_sum);
+}
@@ -0,0 +1,40 @@
+#include "catch.hpp"
+#include "property_tree.h"
+
+namespace {
+/**
+ * @brief Build a tree of about 200k nodes and tear it down again.
+ * @tparam Tree The tree type.
+ * @param paths The leaf paths.
+ * @return The number of nodes below the root.
+ */
+template<typename Tree>
+int BuildAndClear(const std::vector<CompiledPath> &paths) {
+  Tree tree;
+  for (auto &path : paths) {
+    tree.SetData(path, 1);
+  }
+  std::vector<std::string> children;
+  int count = static_cast<int>(tree.ListChildren(children));
+  tree.clear();
+  return count;
+}
+}
+
+TEST_CASE("Node allocation startup and teardown") {
+  std::vector<CompiledPath> paths;
+  for (int i = 0; i < 50000; i++) {
+    paths.emplace_back("config.unit" + std::to_string(i / 500) + ".device" + std::to_string(i) + ".sensor.value");
+  }
+
+  int count = 0;
+  BENCHMARK("heap allocated nodes") {
+    count += BuildAndClear<PropertyTree<std::string, int>>(paths);
+  }
+
+  BENCHMARK("pool allocated nodes") {
+    count += BuildAndClear<PropertyTree<std::string, int, MapChildren, PoolAllocation<>>>(paths);
+  }
+
+  REQUIRE(count == 2);
+}
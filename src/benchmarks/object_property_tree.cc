@@ -0,0 +1,139 @@
+#include "catch.hpp"
+#include "subtree_view.h"
+
+TEST_CASE("ObjectTree multi-get") {
+  ObjectPropertyTree object_tree;
+  std::vector<std::string> leaves;
+  for (int i = 0; i < 40; i++) {
+    leaves.push_back("field" + std::to_string(i));
+  }
+  for (int session = 0; session < 1000; session++) {
+    for (auto &leaf : leaves) {
+      object_tree.SetObject("session." + std::to_string(session) + "." + leaf, session);
+    }
+  }
+  std::vector<std::string> paths;
+  for (auto &leaf : leaves) {
+    paths.push_back("session.500." + leaf);
+  }
+
+  long sum = 0;
+  BENCHMARK("GetObject per leaf") {
+    for (int i = 0; i < 1000; i++) {
+      for (auto &path : paths) {
+        sum += object_tree.GetObject<int>(path);
+      }
+    }
+  }
+
+  std::vector<int> objects;
+  BENCHMARK("GetObjects with full paths") {
+    for (int i = 0; i < 1000; i++) {
+      object_tree.GetObjects(paths, objects);
+    }
+  }
+
+  BENCHMARK("GetObjects below a prefix") {
+    for (int i = 0; i < 1000; i++) {
+      object_tree.GetObjects("session.500", leaves, objects);
+    }
+  }
+
+  REQUIRE(sum == 500L * 1000 * 40);
+  REQUIRE(objects.size() == leaves.size());
+  REQUIRE(objects.back() == 500);
+}
+
+TEST_CASE("ObjectTree handles") {
+  ObjectPropertyTree object_tree;
+  for (int session = 0; session < 1000; session++) {
+    for (int field = 0; field < 40; field++) {
+      object_tree.SetObject("session." + std::to_string(session) + ".field" + std::to_string(field), session);
+    }
+  }
+  std::vector<std::string> paths;
+  std::vector<NodeHandle> handles;
+  for (int field = 0; field < 40; field++) {
+    paths.push_back("session.500.field" + std::to_string(field));
+    handles.push_back(object_tree.Resolve(paths.back()));
+  }
+
+  long path_sum = 0;
+  BENCHMARK("GetObject by path") {
+    for (int i = 0; i < 1000; i++) {
+      for (auto &path : paths) {
+        path_sum += object_tree.GetObject<int>(path);
+      }
+    }
+  }
+
+  long handle_sum = 0;
+  BENCHMARK("GetObject by handle") {
+    for (int i = 0; i < 1000; i++) {
+      for (auto &handle : handles) {
+        handle_sum += object_tree.GetObject<int>(handle);
+      }
+    }
+  }
+
+  REQUIRE(path_sum == 500L * 1000 * 40);
+  REQUIRE(handle_sum == path_sum);
+}
+
+TEST_CASE("ObjectTree subtree view") {
+  ObjectPropertyTree object_tree;
+  std::vector<std::string> paths;
+  std::vector<std::string> leaves;
+  for (int field = 0; field < 40; field++) {
+    leaves.push_back("settings.field" + std::to_string(field));
+    paths.push_back("tenants.tenant500." + leaves.back());
+  }
+  for (int tenant = 0; tenant < 1000; tenant++) {
+    for (auto &leaf : leaves) {
+      object_tree.SetObject("tenants.tenant" + std::to_string(tenant) + "." + leaf, tenant);
+    }
+  }
+  SubtreeView view(object_tree, "tenants.tenant500");
+
+  BENCHMARK("SetObject and GetObject by full path") {
+    for (int i = 0; i < 1000; i++) {
+      for (auto &path : paths) {
+        object_tree.SetObject(path, object_tree.GetObject<int>(path) + 1);
+      }
+    }
+  }
+
+  BENCHMARK("SetObject and GetObject through a view") {
+    for (int i = 0; i < 1000; i++) {
+      for (auto &leaf : leaves) {
+        view.SetObject(leaf, view.GetObject<int>(leaf) + 1);
+      }
+    }
+  }
+
+  REQUIRE(view.GetObject<int>(leaves[0]) == 2500);
+}
+
+TEST_CASE("ObjectTree read in place") {
+  ObjectPropertyTree object_tree;
+  object_tree.Emplace<std::vector<int>>("tables.large", 100000, 1);
+
+  long copy_sum = 0;
+  BENCHMARK("GetObject copy of a large vector") {
+    for (int i = 0; i < 100; i++) {
+      for (int value : object_tree.GetObject<std::vector<int>>("tables.large")) copy_sum += value;
+    }
+  }
+
+  long read_sum = 0;
+  BENCHMARK("Read of a large vector") {
+    for (int i = 0; i < 100; i++) {
+      object_tree.Read<std::vector<int>>("tables.large", [&read_sum](const std::vector<int> &values) {
+        for (int value : values) read_sum += value;
+      });
+    }
+  }
+
+  REQUIRE(copy_sum == 100L * 100000);
+  REQUIRE(read_sum == copy_sum);
+}
@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "object_property_tree.h"
+#include <boost/any.hpp>
+#include <malloc.h>
+
+/**
+ * @brief Build a tree of 1M int and double leaves, and report the time and the heap it takes.
+ * @tparam Tree The tree type.
+ * @param name The name to report.
+ */
+template<typename Tree>
+static void MeasureLeaves(const std::string &name) {
+  std::size_t before = mallinfo2().uordblks;
+  std::size_t after = before;
+  double sum = 0;
+  BENCHMARK(name + " building 1M leaves") {
+    Tree tree;
+    std::string path;
+    for (int i = 0; i < 1000000; i++) {
+      path = "grid.row" + std::to_string(i / 1000) + ".cell" + std::to_string(i % 1000);
+      if (i % 2) {
+        tree.SetData(path, 0.5 * i);
+      } else {
+        tree.SetData(path, i);
+      }
+    }
+    after = mallinfo2().uordblks;
+    typename Tree::PropertyNode *node = tree.GetNode("grid.row999.cell999");
+    sum += node ? 1 : 0;
+  }
+  WARN(name << ": " << (after - before) / 1000000.0 << " heap bytes per leaf");
+  REQUIRE(sum == 1);
+}
+
+TEST_CASE("ObjectValue memory") {
+  MeasureLeaves<PropertyTree<std::string, boost::any>>("boost::any");
+  MeasureLeaves<PropertyTree<std::string, ObjectValue>>("ObjectValue");
+}
+
+/**
+ * @brief Store 100k pointers to small objects, and report the time and the heap it takes.
+ * @tparam F The type of the setter, called as set(tree, path, value).
+ * @param name The name to report.
+ * @param set Stores a pointer.
+ */
+template<typename F>
+static void MeasurePointers(const std::string &name, F set) {
+  ObjectPropertyTree tree;
+  std::vector<std::string> paths;
+  for (int i = 0; i < 100000; i++) {
+    paths.push_back("objects.row" + std::to_string(i / 1000) + ".cell" + std::to_string(i % 1000));
+    tree.SetObject(paths.back(), 0);
+  }
+  std::size_t before = mallinfo2().uordblks;
+  std::size_t after = before;
+  BENCHMARK(name + " storing 100k pointers") {
+    for (int i = 0; i < 100000; i++) {
+      set(tree, paths[i], i);
+    }
+    after = mallinfo2().uordblks;
+  }
+  WARN(name << ": " << double(after - before) / 100000 << " heap bytes per pointer");
+  REQUIRE(*tree.GetPointer<long>(paths[99999]) == 99999);
+}
+
+TEST_CASE("ObjectTree pointer memory") {
+  MeasurePointers("SetPointer(T *)", [](ObjectPropertyTree &tree, const std::string &path, long value) {
+    tree.SetPointer(path, new long(value));
+  });
+  MeasurePointers("SetPointer(make_shared)", [](ObjectPropertyTree &tree, const std::string &path, long value) {
+    tree.SetPointer(path, std::make_shared<long>(value));
+  });
+  MeasurePointers("EmplacePointer", [](ObjectPropertyTree &tree, const std::string &path, long value) {
+    tree.EmplacePointer<long>(path, value);
+  });
+}
@@ -0,0 +1,67 @@
+#include "catch.hpp"
+#include "property_tree.h"
+#include <malloc.h>
+
+TEST_CASE("PropertyTree ingestion") {
+  std::vector<std::string> paths;
+  for (int i = 0; i < 20000; i++) {
+    paths.push_back("plant.area" + std::to_string(i % 8) + ".unit" + std::to_string(i % 64) + ".device"
+                        + std::to_string(i % 512) + ".sensor" + std::to_string(i) + ".value");
+  }
+
+  int data = 0;
+  BENCHMARK("SetData creating deep paths") {
+    PropertyTree<std::string, int> tree;
+    for (auto &path : paths) {
+      tree.SetData(path, 1);
+    }
+    tree.GetData(paths.back(), data);
+  }
+
+  PropertyTree<std::string, int> tree;
+  for (auto &path : paths) {
+    tree.SetData(path, 1);
+  }
+  BENCHMARK("SetData updating deep paths") {
+    for (auto &path : paths) {
+      tree.SetData(path, 2);
+    }
+  }
+  tree.GetData(paths.front(), data);
+
+  REQUIRE(data == 2);
+}
+
+/**
+ * @brief Build a mostly-leaf tree of 10k devices with 6 properties each, and report the node size and the heap it takes.
+ * @tparam C The children container policy.
+ * @param name The name to report.
+ */
+template<typename C>
+static void MeasureChildren(const std::string &name) {
+  static const char *properties[] = {"temperature", "humidity", "status", "firmware", "uptime", "name"};
+  const std::size_t nodes = 1 + 10000 * 7;
+  std::size_t before = mallinfo2().uordblks;
+  std::size_t after = before;
+  int data = 0;
+  BENCHMARK(name + " building 10k devices") {
+    PropertyTree<std::string, int, C> tree;
+    for (int device = 0; device < 10000; device++) {
+      std::string path = "site.device" + std::to_string(device) + ".";
+      for (const char *property : properties) {
+        tree.SetData(path + property, device);
+      }
+    }
+    after = mallinfo2().uordblks;
+    tree.GetData("site.device9999.name", data);
+  }
+  WARN(name << ": " << sizeof(typename PropertyTree<std::string, int, C>::PropertyNode) << " byte nodes, "
+            << double(after - before) / nodes << " heap bytes per node");
+  REQUIRE(data == 9999);
+}
+
+TEST_CASE("PropertyTree children memory") {
+  MeasureChildren<MapChildren>("MapChildren");
+  MeasureChildren<FlatHashChildren>("FlatHashChildren");
+  MeasureChildren<SmallVectorChildren<4>>("SmallVectorChildren<4>");
+}
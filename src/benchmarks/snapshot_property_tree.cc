@@ -0,0 +1,43 @@
+#include "catch.hpp"
+#include "property_tree.h"
+#include "snapshot_property_tree.h"
+#include <boost/thread.hpp>
+
+TEST_CASE("Snapshot reads") {
+  std::vector<CompiledPath> paths;
+  for (int i = 0; i < 20000; i++) {
+    paths.emplace_back("config.unit" + std::to_string(i % 100) + ".setting" + std::to_string(i));
+  }
+
+  PropertyTree<std::string, int> locked;
+  SnapshotPropertyTree<std::string, int> snapshots;
+  for (auto &path : paths) {
+    locked.SetData(path, 1);
+    snapshots.SetData(path, 1);
+  }
+
+  // A request reads a handful of settings while a writer updates one now and then.
+  long sum = 0;
+  int data = 0;
+  BENCHMARK("requests on a locked tree") {
+    for (std::size_t i = 0; i + 8 <= paths.size(); i += 8) {
+      if (i % 4096 == 0) locked.SetData(paths[i], 1);
+      for (std::size_t j = i; j < i + 8; j++) {
+        locked.GetData(paths[j], data);
+        sum += data;
+      }
+    }
+  }
+  BENCHMARK("requests on snapshots") {
+    for (std::size_t i = 0; i + 8 <= paths.size(); i += 8) {
+      if (i % 4096 == 0) snapshots.SetData(paths[i], 1);
+      auto snapshot = snapshots.snapshot();
+      for (std::size_t j = i; j < i + 8; j++) {
+        snapshot.GetData(paths[j], data);
+        sum += data;
+      }
+    }
+  }
+
+  REQUIRE(sum == 2 * static_cast<long>(paths.size()));
+}
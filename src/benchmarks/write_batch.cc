@@ -0,0 +1,47 @@
+#include "catch.hpp"
+#include "property_tree.h"
+
+TEST_CASE("Batched writes") {
+  // Messages of 200 leaves each, with unsorted fields.
+  std::vector<std::vector<std::string>> messages;
+  for (int m = 0; m < 100; m++) {
+    std::vector<std::string> message;
+    for (int i = 0; i < 200; i++) {
+      message.push_back("ingest.source" + std::to_string(m % 10) + ".group" + std::to_string((i * 7) % 20) + ".field"
+                            + std::to_string(i) + ".value");
+    }
+    messages.push_back(message);
+  }
+
+  PropertyTree<std::string, int> single;
+  PropertyTree<std::string, int> batched;
+  for (auto &message : messages) {
+    for (auto &path : message) {
+      single.SetData(path, 0);
+      batched.SetData(path, 0);
+    }
+  }
+
+  BENCHMARK("SetData per leaf") {
+    for (auto &message : messages) {
+      for (auto &path : message) {
+        single.SetData(path, 1);
+      }
+    }
+  }
+
+  WriteBatch<std::string, int> batch;
+  BENCHMARK("WriteBatch per message") {
+    for (auto &message : messages) {
+      batch.clear();
+      for (auto &path : message) {
+        batch.Set(path, 1);
+      }
+      batched.Apply(batch);
+    }
+  }
+
+  int data = 0;
+  batched.GetData(messages.back().back(), data);
+  REQUIRE(data == 1);
+}
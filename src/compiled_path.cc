@@ -0,0 +1,9 @@
+#include "compiled_path.h"
+#include "key_intern_table.h"
+
+CompiledPath &CompiledPath::Intern() {
+  for (auto &segment : segments_) {
+    segment.atom = KeyInternTable::Global().Intern(segment);
+  }
+  return *this;
+}
@@ -0,0 +1 @@
+#include "concurrent_node.h"
@@ -0,0 +1 @@
+#include "concurrent_property_tree.h"
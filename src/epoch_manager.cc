@@ -0,0 +1,117 @@
+#include "epoch_manager.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+/**
+ * @brief Owns the slot of a thread and gives it back when the thread exits.
+ */
+struct ThreadSlotHolder {
+  EpochManager::Slot *slot = nullptr; ///< The slot or nullptr before the first Enter.
+
+  ~ThreadSlotHolder() {
+    if (slot) {
+      slot->epoch.store(0);
+      slot->used.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local ThreadSlotHolder thread_slot;
+}
+
+constexpr std::size_t EpochManager::MAX_THREADS;
+constexpr std::size_t EpochManager::RECLAIM_THRESHOLD;
+
+EpochManager::~EpochManager() {
+  // Deleters may retire more memory.
+  while (!retired_.empty()) {
+    std::vector<Retired> retired;
+    retired.swap(retired_);
+    Free(retired);
+  }
+}
+
+EpochManager &EpochManager::Global() {
+  static EpochManager manager;
+  return manager;
+}
+
+void EpochManager::Enter() {
+  Slot &slot = ThreadSlot();
+  if (slot.depth++ == 0) {
+    slot.epoch.store(epoch_.load());
+    // The announcement must be visible before the reader loads any pointer, see Reclaim.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+void EpochManager::Exit() {
+  Slot &slot = *thread_slot.slot;
+  if (--slot.depth == 0) {
+    slot.epoch.store(0, std::memory_order_release);
+  }
+}
+
+void EpochManager::Retire(void *pointer, void (*deleter)(void *)) {
+  // Readers entering after the increment announce a later epoch and cannot have seen the pointer.
+  std::uint64_t epoch = epoch_.fetch_add(1);
+  std::vector<Retired> freed;
+  {
+    std::lock_guard<std::mutex> l(retired_mutex_);
+    retired_.push_back(Retired{pointer, deleter, epoch});
+    if (retired_.size() % RECLAIM_THRESHOLD == 0) freed = CollectLocked();
+  }
+  Free(freed);
+}
+
+std::size_t EpochManager::Reclaim() {
+  std::vector<Retired> freed;
+  {
+    std::lock_guard<std::mutex> l(retired_mutex_);
+    freed = CollectLocked();
+  }
+  Free(freed);
+  return freed.size();
+}
+
+std::size_t EpochManager::pending() const {
+  std::lock_guard<std::mutex> l(retired_mutex_);
+  return retired_.size();
+}
+
+EpochManager::Slot &EpochManager::ThreadSlot() {
+  if (!thread_slot.slot) {
+    for (auto &slot : slots_) {
+      bool used = false;
+      if (!slot.used.load(std::memory_order_relaxed) && slot.used.compare_exchange_strong(used, true)) {
+        thread_slot.slot = &slot;
+        break;
+      }
+    }
+    if (!thread_slot.slot) throw std::runtime_error("EpochManager: too many threads");
+  }
+  return *thread_slot.slot;
+}
+
+std::vector<EpochManager::Retired> EpochManager::CollectLocked() {
+  // Pairs with the fence in Enter: either a reader's announcement is seen here, or the reader sees the unlink.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+  for (auto &slot : slots_) {
+    std::uint64_t epoch = slot.epoch.load();
+    if (epoch) oldest = std::min(oldest, epoch);
+  }
+  auto first_freed = std::partition(retired_.begin(), retired_.end(),
+                                    [oldest](const Retired &retired) { return retired.epoch >= oldest; });
+  std::vector<Retired> freed(first_freed, retired_.end());
+  retired_.erase(first_freed, retired_.end());
+  return freed;
+}
+
+void EpochManager::Free(const std::vector<Retired> &retired) {
+  for (auto &item : retired) {
+    item.deleter(item.pointer);
+  }
+}
@@ -0,0 +1 @@
+#include "epoch_node.h"
@@ -0,0 +1 @@
+#include "epoch_property_tree.h"
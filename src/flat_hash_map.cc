@@ -0,0 +1 @@
+#include "flat_hash_map.h"
@@ -0,0 +1,54 @@
+#include "key_intern_table.h"
+
+const std::string &KeyAtom::str() const {
+  return KeyInternTable::Global().Name(*this);
+}
+
+std::ostream &operator<<(std::ostream &output_stream, const KeyAtom &atom) {
+  return output_stream << atom.str();
+}
+
+KeyInternTable &KeyInternTable::Global() {
+  static KeyInternTable table;
+  return table;
+}
+
+KeyAtom KeyInternTable::Intern(boost::string_view name) {
+  KeyAtom atom = Find(name);
+  if (!atom) {
+    boost::unique_lock<boost::shared_mutex> l(mutex_);
+    auto i = ids_.find(name); // may have been added since the shared lock was released
+    if (i != ids_.end()) return KeyAtom(i->second);
+    names_.emplace_back(name.data(), name.size());
+    auto id = static_cast<std::uint32_t>(names_.size());
+    ids_.emplace(boost::string_view(names_.back()), id);
+    atom = KeyAtom(id);
+  }
+  return atom;
+}
+
+KeyAtom KeyInternTable::Find(boost::string_view name) const {
+  boost::shared_lock<boost::shared_mutex> l(mutex_);
+  auto i = ids_.find(name);
+  return i == ids_.end() ? KeyAtom() : KeyAtom(i->second);
+}
+
+const std::string &KeyInternTable::Name(KeyAtom atom) const {
+  static const std::string empty;
+  boost::shared_lock<boost::shared_mutex> l(mutex_);
+  if (!atom || atom.id > names_.size()) return empty;
+  return names_[atom.id - 1];
+}
+
+std::size_t KeyInternTable::size() const {
+  boost::shared_lock<boost::shared_mutex> l(mutex_);
+  return names_.size();
+}
+
+KeyAtom NodeKeyTraits<KeyAtom>::Make(boost::string_view segment) {
+  return KeyInternTable::Global().Intern(segment);
+}
+
+KeyAtom NodeKeyTraits<KeyAtom>::Lookup(boost::string_view segment) {
+  return KeyInternTable::Global().Find(segment);
+}
@@ -0,0 +1 @@
+#include "leaf_column.h"
@@ -0,0 +1 @@
+#include "node_children.h"
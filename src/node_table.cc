@@ -0,0 +1 @@
+#include "node_table.h"
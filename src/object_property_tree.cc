@@ -4,7 +4,7 @@ void ObjectPropertyTree::PrintNode(std::ostream &output_stream, ObjectNode *obje
   if (object_node) {
     std::string indent(level*2, ' ');
 
-    output_stream << indent << object_node->name() << ":" << object_node->data().type().name();
+    output_stream << indent << object_node->name() << ":" << object_node->data().type_id().name();
     if (object_node->data().empty()) {
       output_stream << ": EMPTY";
     } else {
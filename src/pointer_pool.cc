@@ -0,0 +1 @@
+#include "pointer_pool.h"
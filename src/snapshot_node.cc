@@ -0,0 +1 @@
+#include "snapshot_node.h"
@@ -0,0 +1 @@
+#include "snapshot_property_tree.h"
@@ -0,0 +1,140 @@
+#include "subscription_manager.h"
+#include <algorithm>
+#include <utility>
+
+SubscriptionManager::~SubscriptionManager() { Stop(); }
+
+void SubscriptionManager::Stop() {
+  std::thread dispatcher;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stopping_ = true;
+    dispatcher.swap(dispatcher_);
+  }
+  wake_.notify_all();
+  if (dispatcher.joinable()) dispatcher.join();
+}
+
+std::size_t SubscriptionManager::Subscribe(boost::string_view pattern, Callback callback) {
+  auto subscription = std::make_shared<Subscription>();
+  for (auto segment : PathTokenizer(pattern)) {
+    subscription->pattern.emplace_back(segment.data(), segment.size());
+  }
+  subscription->callback = std::move(callback);
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!dispatcher_.joinable() && !stopping_) dispatcher_ = std::thread(&SubscriptionManager::Run, this);
+  std::size_t id = next_id_++;
+  subscriptions_.emplace(id, std::move(subscription));
+  subscriptions_count_ = subscriptions_.size();
+  return id;
+}
+
+void SubscriptionManager::Unsubscribe(std::size_t id) {
+  std::lock_guard<std::mutex> l(mutex_);
+  subscriptions_.erase(id);
+  subscriptions_count_ = subscriptions_.size();
+}
+
+void SubscriptionManager::Publish(const std::string &path, ChangeEvent::Kind kind, std::uint64_t generation) {
+  bool wake;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    wake = Record(ChangeEvent{path, kind, generation});
+  }
+  if (wake) wake_.notify_one();
+}
+
+void SubscriptionManager::Publish(const std::vector<ChangeEvent> &events) {
+  bool wake = false;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto &event : events) {
+      wake = Record(event) || wake;
+    }
+  }
+  if (wake) wake_.notify_one();
+}
+
+bool SubscriptionManager::Record(const ChangeEvent &event) {
+  bool was_pending = pending_;
+  for (auto &entry : subscriptions_) {
+    Subscription &subscription = *entry.second;
+    if (Matches(subscription.pattern, event.path, event.kind)) {
+      subscription.pending[event.path] = std::make_pair(recorded_, event);
+      pending_ = true;
+    }
+  }
+  recorded_++;
+  return pending_ && !was_pending;
+}
+
+void SubscriptionManager::Flush() {
+  std::unique_lock<std::mutex> l(mutex_);
+  if (stopping_ || (!pending_ && !delivering_)) return;
+  flushing_ = true;
+  wake_.notify_one();
+  while ((pending_ && !stopping_) || delivering_) idle_.wait(l);
+  flushing_ = false;
+}
+
+void SubscriptionManager::Run() {
+  std::unique_lock<std::mutex> l(mutex_);
+  while (!stopping_) {
+    if (!pending_) {
+      wake_.wait(l);
+      continue;
+    }
+    // Let a burst collect before taking the batch.
+    auto deadline = std::chrono::steady_clock::now() + delay_;
+    while (!stopping_ && !flushing_ && std::chrono::steady_clock::now() < deadline) {
+      wake_.wait_until(l, deadline);
+    }
+    if (stopping_) break;
+
+    std::vector<std::pair<std::shared_ptr<Subscription>, std::vector<ChangeEvent>>> batches;
+    for (auto &entry : subscriptions_) {
+      auto &pending = entry.second->pending;
+      if (pending.empty()) continue;
+      // Changes are recorded under the tree lock, so the record numbers give the order they were made in, also
+      // within a WriteBatch, whose changes share a generation.
+      std::vector<std::pair<std::uint64_t, ChangeEvent>> changes;
+      changes.reserve(pending.size());
+      for (auto &change : pending) {
+        changes.push_back(std::move(change.second));
+      }
+      pending.clear();
+      std::sort(changes.begin(), changes.end(),
+                [](const std::pair<std::uint64_t, ChangeEvent> &a, const std::pair<std::uint64_t, ChangeEvent> &b) {
+                  return a.first < b.first;
+                });
+      std::vector<ChangeEvent> events;
+      events.reserve(changes.size());
+      for (auto &change : changes) {
+        events.push_back(std::move(change.second));
+      }
+      batches.emplace_back(entry.second, std::move(events));
+    }
+    pending_ = false;
+    delivering_ = true;
+    l.unlock();
+    for (auto &batch : batches) {
+      batch.first->callback(batch.second);
+    }
+    l.lock();
+    delivering_ = false;
+    if (!pending_) idle_.notify_all();
+  }
+  // Changes left are dropped, release the waiting Flush calls.
+  idle_.notify_all();
+}
+
+bool SubscriptionManager::Matches(const std::vector<std::string> &pattern, boost::string_view path,
+                                  ChangeEvent::Kind kind) {
+  auto name = pattern.begin();
+  for (auto segment : PathTokenizer(path)) {
+    if (name == pattern.end()) return true; // below the pattern
+    if (*name != "*" && boost::string_view(*name) != segment) return false;
+    ++name;
+  }
+  return name == pattern.end() || kind == ChangeEvent::REMOVED;
+}
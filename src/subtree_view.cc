@@ -0,0 +1 @@
+#include "subtree_view.h"
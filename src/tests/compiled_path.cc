@@ -0,0 +1,48 @@
+#include "catch.hpp"
+#include "compiled_path.h"
+#include "object_property_tree.h"
+
+TEST_CASE("CompiledPath") {
+  CompiledPath path("This.is..path.one");
+  REQUIRE(path.str() == "This.is..path.one");
+  REQUIRE(path.size() == 4);
+  REQUIRE(path[0] == "This");
+  REQUIRE(path[3] == "one");
+  REQUIRE(path[2].hash == NodeKeyHash()(std::string("path")));
+  REQUIRE(CompiledPath().empty());
+
+  // Copies and moves keep pointing at their own string.
+  CompiledPath copy(path);
+  REQUIRE(copy[1] == "is");
+  REQUIRE(copy[1].data() >= copy.str().data());
+  REQUIRE(copy[1].data() < copy.str().data() + copy.str().size());
+  CompiledPath short_path("a.b");
+  CompiledPath moved(std::move(short_path));
+  REQUIRE(moved.size() == 2);
+  REQUIRE(moved[1] == "b");
+  REQUIRE(moved[1].data() == moved.str().data() + 2);
+  copy = moved;
+  REQUIRE(copy[0] == "a");
+  REQUIRE(copy[0].data() == copy.str().data());
+
+  // Accepted by the tree accessors.
+  ObjectPropertyTree object_tree;
+  int object1 = 42;
+  CompiledPath path1("objects.object1");
+  CompiledPath path2("objects.object2");
+  CompiledPath path3("objects.object3");
+  object_tree.SetObject(path1, object1);
+  REQUIRE(object_tree.GetObject<int>(path1) == 42);
+  REQUIRE(object_tree.GetObject<int>("objects.object1") == 42);
+  REQUIRE(object_tree.exists(path1));
+  REQUIRE(!object_tree.exists(path3));
+
+  object_tree.SetPointer(path2, new std::string("pointer"));
+  REQUIRE(*object_tree.GetPointer<std::string>(path2) == "pointer");
+  REQUIRE(object_tree.GetPointer<int>(path2) == nullptr);
+
+  std::vector<std::string> children;
+  REQUIRE(object_tree.ListChildren(CompiledPath("objects"), children) == 2);
+  object_tree.remove(path1);
+  REQUIRE(!object_tree.exists("objects.object1"));
+}
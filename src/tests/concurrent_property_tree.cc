@@ -0,0 +1,63 @@
+#include "catch.hpp"
+#include "concurrent_property_tree.h"
+#include <boost/thread.hpp>
+
+TEST_CASE("ConcurrentPropertyTree") {
+  ConcurrentPropertyTree<std::string, int> tree;
+  std::vector<std::string> children;
+  int data = 0;
+
+  // Adding and reading nodes
+  REQUIRE(!tree.changed());
+  tree.SetData("child_a.child_1", 1);
+  tree.SetData(CompiledPath("child_a.child_2"), 2);
+  REQUIRE(tree.changed());
+  REQUIRE(tree.exists("child_a"));
+  REQUIRE(!tree.exists("child_b"));
+  REQUIRE(!tree.exists(""));
+  REQUIRE(tree.GetData("child_a.child_2", data));
+  REQUIRE(data == 2);
+  REQUIRE(!tree.GetData("child_a.child_3", data));
+  REQUIRE(tree.ListChildren(children) == 1);
+  REQUIRE(tree.ListChildren("child_a", children) == 2);
+
+  // Removing nodes
+  tree.remove("child_a.child_1");
+  REQUIRE(!tree.exists("child_a.child_1"));
+  tree.remove("child_a.missing.child");
+  tree.remove("child_a");
+  REQUIRE(tree.ListChildren(children) == 0);
+
+  // Writers, readers and removers on overlapping paths.
+  std::vector<std::string> paths;
+  for (int i = 0; i < 16; i++) {
+    paths.push_back("unit" + std::to_string(i % 4) + ".device" + std::to_string(i) + ".value");
+  }
+  boost::thread_group threads;
+  for (int t = 0; t < 4; t++) {
+    threads.create_thread([&tree, &paths, t]() {
+      int value = 0;
+      for (int i = 0; i < 2000; i++) {
+        auto &path = paths[(i * 7 + t) % paths.size()];
+        switch ((i + t) % 4) {
+          case 0:
+          case 1:tree.SetData(path, i);
+            break;
+          case 2:tree.GetData(path, value);
+            break;
+          default:tree.remove(path.substr(0, path.find('.')));
+        }
+      }
+    });
+  }
+  threads.join_all();
+  tree.clear();
+  REQUIRE(tree.ListChildren(children) == 0);
+
+  // Pool allocated nodes.
+  ConcurrentPropertyTree<std::string, int, FlatHashChildren, PoolAllocation<>> pooled;
+  pooled.SetData("a.b", 1);
+  pooled.SetData("a.c", 2);
+  REQUIRE(pooled.ListChildren("a", children, true) == 2);
+  REQUIRE(children.front() == "b");
+}
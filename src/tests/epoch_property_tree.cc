@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include "epoch_property_tree.h"
+#include <boost/thread.hpp>
+
+TEST_CASE("EpochPropertyTree") {
+  EpochPropertyTree<std::string, int> tree;
+  std::vector<std::string> children;
+  int data = 0;
+  EpochManager &epochs = EpochManager::Global();
+  epochs.Reclaim();
+
+  // Adding and reading nodes
+  tree.SetData("child_a.child_1", 1);
+  tree.SetData(CompiledPath("child_a.child_2"), 2);
+  REQUIRE(tree.changed());
+  REQUIRE(tree.exists("child_a"));
+  REQUIRE(!tree.exists("child_b"));
+  REQUIRE(tree.GetData("child_a.child_2", data));
+  REQUIRE(data == 2);
+  REQUIRE(tree.GetData("child_a", data));
+  REQUIRE(data == 0);
+  REQUIRE(!tree.GetData("child_a.child_3", data));
+  REQUIRE(tree.ListChildren(children) == 1);
+  REQUIRE(tree.ListChildren("child_a", children) == 2);
+
+  // A reader inside the tree keeps removed nodes alive until it leaves.
+  {
+    EpochManager::Guard guard;
+    const int *value = tree.Find("child_a.child_1")->data();
+    tree.SetData("child_a.child_1", 3);
+    tree.remove("child_a.child_1");
+    REQUIRE(!tree.exists("child_a.child_1"));
+    epochs.Reclaim();
+    REQUIRE(epochs.pending() >= 3);
+    REQUIRE(*value == 1);
+  }
+  epochs.Reclaim();
+  REQUIRE(epochs.pending() == 0);
+
+  // Lock-free readers against a writer that replaces and removes nodes.
+  boost::thread_group threads;
+  std::atomic<bool> done(false);
+  for (int t = 0; t < 3; t++) {
+    threads.create_thread([&tree, &done]() {
+      int value = 0;
+      std::vector<std::string> names;
+      while (!done) {
+        tree.GetData("unit.device.value", value);
+        tree.ListChildren("unit", names);
+      }
+    });
+  }
+  for (int i = 0; i < 2000; i++) {
+    tree.SetData("unit.device.value", i);
+    if (i % 10 == 0) tree.remove("unit.device");
+    if (i % 100 == 0) tree.clear();
+  }
+  done = true;
+  threads.join_all();
+  tree.clear();
+  epochs.Reclaim();
+  REQUIRE(tree.ListChildren(children) == 0);
+  REQUIRE(epochs.pending() == 0);
+}
+
+namespace {
+
+/**
+ * @brief Frees an int and retires the int after it, as a deleter of a node that retires its children would.
+ */
+void RetireNext(void *pointer) {
+  int *values = static_cast<int *>(pointer);
+  if (values[0] > 0) {
+    int *next = new int[1]{values[0] - 1};
+    EpochManager::Global().Retire(next, RetireNext);
+  }
+  delete[] values;
+}
+
+}
+
+TEST_CASE("EpochManager deleters that retire") {
+  EpochManager &epochs = EpochManager::Global();
+  epochs.Reclaim();
+  epochs.Retire(new int[1]{3}, RetireNext);
+  REQUIRE(epochs.Reclaim() == 1);
+  REQUIRE(epochs.pending() == 1);
+  while (epochs.pending()) epochs.Reclaim();
+}
@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "flat_hash_map.h"
+#include "compiled_path.h"
+#include "property_tree.h"
+#include <random>
+
+TEST_CASE("FlatHashMap") {
+  FlatHashMap<std::string, int> map;
+  std::map<std::string, int> reference;
+
+  // Insert and find.
+  REQUIRE(map.empty());
+  REQUIRE(map.bucket_count() == 0);
+  REQUIRE(map.find("a") == map.end());
+  REQUIRE(map.emplace("a", 1).second);
+  REQUIRE(!map.emplace("a", 2).second);
+  REQUIRE(map.find("a")->second == 1);
+  REQUIRE(map.find(boost::string_view("a"))->second == 1);
+  REQUIRE(map.find(CompiledPath("a")[0])->second == 1);
+  map["b"] = 2;
+  REQUIRE(map["b"] == 2);
+  REQUIRE(map.size() == 2);
+  REQUIRE(map.count("c") == 0);
+
+  // Random inserts and erases agree with std::map.
+  std::mt19937 random(42);
+  for (int i = 0; i < 20000; i++) {
+    std::string key = std::to_string(random() % 2000);
+    if (random() % 3) {
+      map.emplace(key, i);
+      reference.emplace(key, i);
+    } else {
+      REQUIRE(map.erase(key) == reference.erase(key));
+    }
+  }
+  REQUIRE(map.size() == reference.size() + 2);
+  for (auto &entry : reference) {
+    auto i = map.find(entry.first);
+    REQUIRE(i != map.end());
+    REQUIRE(i->second == entry.second);
+  }
+  std::size_t visited = 0;
+  for (auto &entry : map) {
+    REQUIRE((entry.first == "a" || entry.first == "b" || reference.count(entry.first) == 1));
+    visited++;
+  }
+  REQUIRE(visited == map.size());
+
+  // Copy, move and clear.
+  FlatHashMap<std::string, int> copy(map);
+  REQUIRE(copy.size() == map.size());
+  REQUIRE(copy.find("a")->second == 1);
+  FlatHashMap<std::string, int> moved(std::move(copy));
+  REQUIRE(moved.size() == map.size());
+  REQUIRE(copy.empty());
+  moved.erase(moved.find("a"));
+  REQUIRE(moved.find("a") == moved.end());
+  moved.clear();
+  REQUIRE(moved.empty());
+  REQUIRE(moved.begin() == moved.end());
+
+  // A tree with wide nodes.
+  PropertyTree<std::string, int, FlatHashChildren> tree;
+  std::vector<std::string> children;
+  for (int i = 0; i < 50000; i++) {
+    tree.SetData("devices.device" + std::to_string(i) + ".value", i);
+  }
+  int data = 0;
+  tree.GetData("devices.device4242.value", data);
+  REQUIRE(data == 4242);
+  REQUIRE(tree.ListChildren("devices", children, true) == 50000);
+  REQUIRE(std::is_sorted(children.begin(), children.end()));
+  tree.remove("devices.device4242");
+  REQUIRE(!tree.exists("devices.device4242.value"));
+  REQUIRE(tree.exists("devices.device4243.value"));
+}
@@ -0,0 +1,65 @@
+#include "catch.hpp"
+#include "atom_property_tree.h"
+
+TEST_CASE("KeyInternTable") {
+  KeyInternTable table;
+
+  // Interning.
+  REQUIRE(table.size() == 0);
+  REQUIRE(!table.Find("config"));
+  KeyAtom config = table.Intern("config");
+  KeyAtom sensor = table.Intern("sensor");
+  REQUIRE(config);
+  REQUIRE(config != sensor);
+  REQUIRE(table.Intern(std::string("config")) == config);
+  REQUIRE(table.Find("sensor") == sensor);
+  REQUIRE(table.Name(config) == "config");
+  REQUIRE(table.Name(KeyAtom()).empty());
+  REQUIRE(table.size() == 2);
+
+  // Concurrent interning gives every thread the same ids.
+  std::vector<KeyAtom> atoms(4);
+  boost::thread_group threads;
+  for (int t = 0; t < 4; t++) {
+    threads.create_thread([&table, &atoms, t]() {
+      for (int i = 0; i < 100; i++) {
+        table.Intern("name" + std::to_string(i));
+      }
+      atoms[t] = table.Find("name50");
+    });
+  }
+  threads.join_all();
+  REQUIRE(table.size() == 102);
+  for (auto &atom : atoms) {
+    REQUIRE(atom == atoms[0]);
+  }
+
+  // A tree keyed by atoms.
+  AtomPropertyTree<int> tree;
+  std::vector<KeyAtom> children;
+  tree.SetData("config.sensor.value", 1);
+  REQUIRE(tree.exists("config.sensor"));
+  int data = 0;
+  tree.GetData("config.sensor.value", data);
+  REQUIRE(data == 1);
+  REQUIRE(tree.ListChildren("config", children) == 1);
+  REQUIRE(children[0].str() == "sensor");
+  REQUIRE(sizeof(tree.GetRootNode().name()) == 4);
+
+  // Misses do not grow the global table.
+  std::size_t size = KeyInternTable::Global().size();
+  REQUIRE(!tree.exists("config.unknown_name"));
+  REQUIRE(KeyInternTable::Global().size() == size);
+
+  // Interned compiled paths.
+  CompiledPath path("config.sensor.value");
+  path.Intern();
+  REQUIRE(path[1].atom == KeyInternTable::Global().Find("sensor"));
+  tree.SetData(path, 2);
+  tree.GetData(path, data);
+  REQUIRE(data == 2);
+  AtomPropertyTree<int>::Path full_path;
+  tree.GetFullPath(tree.Find(path), full_path);
+  REQUIRE(full_path.size() == 3);
+  REQUIRE(full_path[2].str() == "value");
+}
@@ -0,0 +1,48 @@
+#include "catch.hpp"
+#include "leaf_column.h"
+
+TEST_CASE("LeafColumn") {
+  LeafColumn<double> column;
+  REQUIRE(column.type() == TypeId::Of<double>());
+  for (int i = 0; i < 10; i++) {
+    REQUIRE(column.Add(i) == static_cast<std::uint32_t>(i));
+  }
+  REQUIRE(column.at(3) == 3);
+
+  // Summaries run over the collected slots, in any order.
+  int collected = 0;
+  auto odd = [&collected](std::vector<std::uint32_t> &slots) {
+    collected++;
+    for (std::uint32_t slot : {9u, 1u, 5u, 3u, 7u}) slots.push_back(slot);
+  };
+  auto summary = column.Summarize("odd", odd);
+  REQUIRE(summary.count == 5);
+  REQUIRE(summary.sum == 25);
+  REQUIRE(summary.min == 1);
+  REQUIRE(summary.max == 9);
+
+  // The slots are cached until a slot is added or released, the values are read every time.
+  column.at(9) = -1;
+  summary = column.Summarize("odd", odd);
+  REQUIRE(collected == 1);
+  REQUIRE(summary.min == -1);
+  REQUIRE(summary.max == 7);
+  column.Release(9);
+  column.Summarize("odd", odd);
+  REQUIRE(collected == 2);
+  REQUIRE(column.Add(42) == 9);
+  REQUIRE(column.size() == 10);
+
+  summary = column.Summarize("none", [](std::vector<std::uint32_t> &) {});
+  REQUIRE(summary.count == 0);
+  REQUIRE(summary.sum == 0);
+
+  // Sums are kept in a type wider than the values.
+  LeafColumn<int> ints;
+  for (int i = 0; i < 5; i++) ints.Add(2000000000);
+  auto all = ints.Summarize("all", [](std::vector<std::uint32_t> &slots) {
+    for (std::uint32_t slot = 0; slot < 5; slot++) slots.push_back(slot);
+  });
+  REQUIRE(all.sum == 10000000000);
+  REQUIRE(all.max == 2000000000);
+}
@@ -78,4 +78,38 @@ TEST_CASE("Node") {
   REQUIRE(!parent_node.HasChild("child1"));
   REQUIRE(parent_node.GetChild("child1") == nullptr);
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("Node FindOrEmplace") {
+  Node<std::string, int> root("root");
+  NodePool<Node<std::string, int>> pool;
+
+  // Creates the missing levels only.
+  auto *leaf = root.FindOrEmplace("a.b.c", pool);
+  REQUIRE(leaf->name() == "c");
+  REQUIRE(pool.size() == 3);
+  REQUIRE(root.FindOrEmplace("a.b.c", pool) == leaf);
+  REQUIRE(pool.size() == 3);
+  auto *sibling = root.FindOrEmplace(CompiledPath("a.b.d.e"), pool);
+  REQUIRE(pool.size() == 5);
+  REQUIRE(sibling->parent()->parent() == leaf->parent());
+  REQUIRE(root.FindOrEmplace("", pool) == nullptr);
+
+  // Heap nodes by default.
+  auto *heap_leaf = root.FindOrEmplace("x.y");
+  REQUIRE(root.Find("x.y") == heap_leaf);
+  root.RemoveChild("x");
+  REQUIRE(!root.HasChild("x"));
+
+  // Removing and replacing pooled nodes returns their whole subtree to the pool.
+  root.RemoveChild("a", pool);
+  REQUIRE(pool.size() == 0);
+  root.FindOrEmplace("a.b.c", pool);
+  root.AddChild(pool.Create("a", &root), pool);
+  REQUIRE(pool.size() == 1);
+  root.FindOrEmplace("a.b", pool);
+  root.Remove("a.b", pool);
+  REQUIRE(pool.size() == 1);
+  root.DestroyChildren(pool);
+  REQUIRE(pool.size() == 0);
+}
@@ -0,0 +1,66 @@
+#include "catch.hpp"
+#include "property_tree.h"
+#include <memory>
+
+TEST_CASE("NodeAllocator") {
+  typedef Node<std::string, int> TestNode;
+
+  // Slab allocation and free list reuse.
+  NodePool<TestNode, 4> pool;
+  REQUIRE(pool.capacity() == 0);
+  TestNode *node1 = pool.Create("node1");
+  TestNode *node2 = pool.Create("node2", node1);
+  REQUIRE(node2->name() == "node2");
+  REQUIRE(node2->parent() == node1);
+  REQUIRE(pool.size() == 2);
+  REQUIRE(pool.capacity() == 4);
+  pool.Destroy(node2);
+  REQUIRE(pool.size() == 1);
+  REQUIRE(pool.Create("node3") == node2);
+  for (int i = 0; i < 4; i++) {
+    pool.Create("node");
+  }
+  REQUIRE(pool.capacity() == 8);
+
+  // Nodes created and destroyed through an allocator.
+  HeapNodeAllocator<TestNode> heap;
+  TestNode root("root");
+  root.Add("a.b.c", heap);
+  root.Add("a.d", heap);
+  REQUIRE(root.Find("a.b.c"));
+  root.Remove("a.b", heap);
+  REQUIRE(!root.Find("a.b"));
+  REQUIRE(root.Find("a.d"));
+  root.DestroyChildren(heap);
+  REQUIRE(root.children().empty());
+
+  // A tree carving its nodes from a pool.
+  typedef PropertyTree<std::string, std::shared_ptr<int>, MapChildren, PoolAllocation<16>> PoolTree;
+  auto data = std::make_shared<int>(42);
+  {
+    PoolTree tree;
+    for (int i = 0; i < 100; i++) {
+      tree.SetData("devices.device" + std::to_string(i) + ".value", data);
+    }
+    REQUIRE(tree.allocator().size() == 201);
+    REQUIRE(data.use_count() == 101);
+    std::size_t capacity = tree.allocator().capacity();
+
+    // Removed nodes are reused.
+    tree.remove("devices.device0");
+    REQUIRE(tree.allocator().size() == 199);
+    REQUIRE(data.use_count() == 100);
+    tree.SetData("devices.device100.value", data);
+    REQUIRE(tree.allocator().capacity() == capacity);
+
+    // Clearing runs the node destructors and releases the slabs.
+    tree.clear();
+    REQUIRE(data.use_count() == 1);
+    REQUIRE(tree.allocator().capacity() == 0);
+    std::vector<std::string> children;
+    REQUIRE(tree.ListChildren(children) == 0);
+    tree.SetData("devices.device0.value", data);
+    REQUIRE(tree.exists("devices.device0.value"));
+  }
+  REQUIRE(data.use_count() == 1);
+}
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include "object_property_tree.h"
+
+TEST_CASE("NodeTable") {
+  typedef Node<std::string, int> TestNode;
+  TestNode root("root");
+  TestNode *a = root.CreateChild("a");
+  TestNode *b = a->CreateChild("b");
+  NodeTable<TestNode> table;
+  REQUIRE(table.empty());
+  REQUIRE(table.Get(NodeHandle()) == nullptr);
+
+  NodeHandle handle_a = table.Add(a);
+  NodeHandle handle_b = table.Add(b);
+  REQUIRE(handle_a);
+  REQUIRE(table.Add(a) == handle_a);
+  REQUIRE(table.Handle(a) == handle_a);
+  REQUIRE(table.Get(handle_a) == a);
+  REQUIRE(table.Get(handle_b) == b);
+
+  // Removing a subtree makes its handles stale, reusing a slot does not revive them.
+  table.RemoveSubtree(a);
+  REQUIRE(table.empty());
+  REQUIRE(table.Get(handle_a) == nullptr);
+  REQUIRE(table.Get(handle_b) == nullptr);
+  NodeHandle handle_reused = table.Add(b);
+  REQUIRE(handle_reused.slot == handle_b.slot);
+  REQUIRE(handle_reused != handle_b);
+  REQUIRE(table.Get(handle_reused) == b);
+  REQUIRE(table.Get(handle_b) == nullptr);
+
+  // Destroyed nodes free their slots.
+  HeapNodeAllocator<TestNode> heap;
+  root.DestroyChildren(heap);
+  REQUIRE(table.empty());
+  REQUIRE(table.Get(handle_reused) == nullptr);
+}
+
+TEST_CASE("PropertyTree handles") {
+  ObjectPropertyTree tree;
+  tree.SetObject("tenants.acme.quota", 10);
+  tree.SetObject("tenants.acme.name", std::string("Acme"));
+  REQUIRE(!tree.Resolve("tenants.nobody"));
+
+  NodeHandle quota = tree.Resolve("tenants.acme.quota");
+  REQUIRE(quota);
+  REQUIRE(tree.Resolve("tenants.acme.quota") == quota);
+  REQUIRE(tree.exists(quota));
+  REQUIRE(tree.GetObject<int>(quota) == 10);
+  REQUIRE(tree.SetObject(quota, 20));
+  REQUIRE(tree.GetObject<int>("tenants.acme.quota") == 20);
+  ObjectValue value;
+  REQUIRE(tree.GetData(quota, value));
+  REQUIRE(*value.get<int>() == 20);
+
+  // Setting by handle stamps and publishes like setting by path.
+  std::uint64_t generation = tree.generation();
+  REQUIRE(tree.SetData(quota, ObjectValue(30)));
+  REQUIRE(tree.generation() == generation + 1);
+  REQUIRE(tree.GetRootNode().Find("tenants.acme.quota")->version() == generation + 1);
+
+  // Handles go stale when their node or an ancestor is removed, also if the path is created again.
+  NodeHandle acme = tree.Resolve("tenants.acme");
+  tree.remove("tenants.acme");
+  REQUIRE(!tree.exists(quota));
+  REQUIRE(!tree.exists(acme));
+  REQUIRE(tree.GetObject<int>(quota) == 0);
+  REQUIRE(!tree.SetObject(quota, 1));
+  REQUIRE(!tree.GetData(quota, value));
+  tree.SetObject("tenants.acme.quota", 40);
+  REQUIRE(!tree.exists(quota));
+  NodeHandle quota_again = tree.Resolve("tenants.acme.quota");
+  REQUIRE(tree.GetObject<int>(quota_again) == 40);
+
+  // Also when the node is removed through the node API.
+  NodeHandle name = tree.Resolve("tenants.acme.name", true);
+  {
+    WriteLock l(tree.mutex());
+    tree.GetRootNode().Find("tenants.acme")->RemoveChild("name");
+  }
+  REQUIRE(!tree.exists(name));
+  REQUIRE(!tree.Resolve("tenants.acme.name"));
+  tree.clear();
+  REQUIRE(!tree.exists(quota_again));
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include "object_property_tree.h"
+#include <thread>
 
 TEST_CASE("ObjectTree") {
   ObjectPropertyTree object_tree;
@@ -23,24 +24,24 @@ TEST_CASE("ObjectTree") {
   char object3_get = object_tree.GetObject<char>("object3");
   REQUIRE(object3 == object3_get);
 
-  // Set and get pointers.
-  int object4 = 2;
-  std::string object5 = "oh no!";
-  char object6 = 'G';
+  // Set and get pointers. The tree takes ownership.
+  auto *object4 = new int(2);
+  auto *object5 = new std::string("oh no!");
+  auto *object6 = new char('G');
 
   ObjectPath path4;
   path4.ToList("object4");
 
-  object_tree.SetPointer(path4, &object4);
-  object_tree.SetPointer("objects.object5", &object5);
-  object_tree.SetPointer("objects.object6", &object6);
+  object_tree.SetPointer(path4, object4);
+  object_tree.SetPointer("objects.object5", object5);
+  object_tree.SetPointer("objects.object6", object6);
 
   auto *object4_get = object_tree.GetPointer<int>(path4);
-  REQUIRE(object4_get == &object4);
+  REQUIRE(object4_get == object4);
   auto *object5_get = object_tree.GetPointer<std::string>("objects.object5");
-  REQUIRE(object5_get == &object5);
+  REQUIRE(object5_get == object5);
   auto *object6_get = object_tree.GetPointer<char>("objects.object6");
-  REQUIRE(object6_get == &object6);
+  REQUIRE(object6_get == object6);
 
   object_tree.remove("object1.object2");
 
@@ -53,3 +54,293 @@ TEST_CASE("ObjectTree") {
   REQUIRE(!object2_fail);
   REQUIRE(!object2_ptr_fail);
 }
+
+TEST_CASE("ObjectTree multi-get") {
+  ObjectPropertyTree object_tree;
+  object_tree.SetObject("session.7.user", std::string("ada"));
+  object_tree.SetObject("session.7.role", std::string("admin"));
+  object_tree.SetObject("session.7.expires", 3600);
+
+  std::vector<std::string> objects;
+  std::vector<std::string> leaves{"user", "expires", "role", "missing"};
+  REQUIRE(object_tree.GetObjects("session.7", leaves, objects) == 2);
+  REQUIRE(objects == std::vector<std::string>({"ada", "", "admin", ""}));
+
+  std::vector<std::string> paths{"session.7.role", "session.7.user"};
+  REQUIRE(object_tree.GetObjects(paths, objects) == 2);
+  REQUIRE(objects == std::vector<std::string>({"admin", "ada"}));
+
+  // Mixed types are read as object values.
+  std::vector<ObjectValue> values;
+  REQUIRE(object_tree.GetData("session.7", leaves, values) == 3);
+  REQUIRE(*values[1].get<int>() == 3600);
+  REQUIRE(values[3].empty());
+}
+
+TEST_CASE("ObjectTree columns") {
+  ObjectPropertyTree object_tree;
+  object_tree.SetObject("plant.unit0.sensor0.value", 1.0); // set before the column, stays in the node
+  object_tree.RegisterColumn<double>();
+  for (int unit = 0; unit < 3; unit++) {
+    for (int sensor = 1; sensor < 5; sensor++) {
+      object_tree.SetObject("plant.unit" + std::to_string(unit) + ".sensor" + std::to_string(sensor) + ".value",
+                            10.0 * unit + sensor);
+    }
+  }
+  object_tree.SetObject("plant.unit1.name", std::string("boiler"));
+
+  // Column leaves read like any other.
+  REQUIRE(object_tree.GetObject<double>("plant.unit1.sensor2.value") == 12);
+  REQUIRE(object_tree.GetObject<double>("plant.unit0.sensor0.value") == 1);
+  REQUIRE(object_tree.GetObject<int>("plant.unit1.sensor2.value") == 0);
+  REQUIRE(object_tree.GetObject<std::string>("plant.unit1.name") == "boiler");
+
+  auto summary = object_tree.Summarize<double>("plant.unit1");
+  REQUIRE(summary.count == 4);
+  REQUIRE(summary.sum == 50);
+  REQUIRE(summary.min == 11);
+  REQUIRE(summary.max == 14);
+  REQUIRE(object_tree.Summarize<double>("").count == 12);
+  REQUIRE(object_tree.Summarize<double>("plant.unit9").count == 0);
+  REQUIRE(object_tree.Summarize<int>("plant").count == 0);
+
+  // Updates, type changes and removals are reflected.
+  object_tree.SetObject("plant.unit1.sensor1.value", 100.0);
+  summary = object_tree.Summarize<double>("plant.unit1");
+  REQUIRE(summary.max == 100);
+  object_tree.SetObject("plant.unit1.sensor1.value", std::string("offline"));
+  REQUIRE(object_tree.Summarize<double>("plant.unit1").count == 3);
+  object_tree.remove("plant.unit2");
+  REQUIRE(object_tree.Summarize<double>("plant").count == 7);
+
+  // GetData copies column values out, SetData and Apply free the slots of the leaves they replace.
+  ObjectValue value;
+  object_tree.GetData("plant.unit0.sensor2.value", value);
+  REQUIRE(value.is<double>());
+  REQUIRE(*value.get<double>() == 2);
+  std::vector<ObjectValue> values;
+  std::vector<std::string> paths = {"plant.unit0.sensor3.value", "plant.unit1.name", "plant.unit0.sensor0.value"};
+  REQUIRE(object_tree.GetData(paths, values) == 3);
+  REQUIRE(*values[0].get<double>() == 3);
+  REQUIRE(*values[1].get<std::string>() == "boiler");
+  REQUIRE(*values[2].get<double>() == 1);
+  object_tree.SetData("plant.unit0.sensor2.value", ObjectValue(std::string("offline")));
+  REQUIRE(object_tree.Summarize<double>("plant").count == 6);
+  WriteBatch<std::string, ObjectValue> batch;
+  batch.Set("plant.unit0.sensor3.value", ObjectValue(std::string("offline")));
+  object_tree.Apply(batch);
+  REQUIRE(object_tree.Summarize<double>("plant").count == 5);
+  REQUIRE(object_tree.GetObject<std::string>("plant.unit0.sensor3.value") == "offline");
+  object_tree.clear();
+  REQUIRE(object_tree.Summarize<double>("").count == 0);
+
+  // Released slots are reused.
+  object_tree.SetObject("plant.unit0.sensor1.value", 5.0);
+  REQUIRE(object_tree.Summarize<double>("plant").sum == 5);
+}
+
+TEST_CASE("ObjectTree atomic leaves") {
+  ObjectPropertyTree object_tree;
+  object_tree.SetObject("stats.requests", std::int64_t(5));
+  auto requests = object_tree.GetAtomic<std::int64_t>("stats.requests");
+  auto load = object_tree.GetAtomic<double>("stats.load");
+  auto online = object_tree.GetAtomic<bool>("stats.online");
+  REQUIRE(requests);
+  REQUIRE(requests.load() == 5); // the value set before is kept
+  REQUIRE(load.load() == 0);
+
+  // Handles to the same leaf share the value.
+  auto generation = object_tree.generation();
+  REQUIRE(object_tree.GetAtomic<std::int64_t>("stats.requests").fetch_add(2) == 5);
+  REQUIRE(requests.load() == 7);
+  REQUIRE(object_tree.generation() == generation);
+  load.store(0.5);
+  REQUIRE(load.fetch_add(0.25) == 0.5);
+  online.store(true);
+
+  // Readers see the atomic values, SetObject writes them.
+  REQUIRE(object_tree.GetObject<std::int64_t>("stats.requests") == 7);
+  REQUIRE(object_tree.GetObject<double>("stats.load") == 0.75);
+  REQUIRE(object_tree.GetObject<bool>("stats.online"));
+  REQUIRE(object_tree.GetObject<int>("stats.requests") == 7);
+  object_tree.SetObject("stats.requests", std::int64_t(100));
+  REQUIRE(requests.load() == 100);
+  std::vector<std::int64_t> values;
+  std::vector<std::string> leaves{"requests", "missing"};
+  REQUIRE(object_tree.GetObjects("stats", leaves, values) == 1);
+  REQUIRE(values[0] == 100);
+
+  // Other numbers are converted into the cell, other objects are refused, and the handles stay attached.
+  REQUIRE(object_tree.SetObject("stats.requests", 5));
+  REQUIRE(requests.load() == 5);
+  REQUIRE(object_tree.SetObject("stats.load", 2));
+  REQUIRE(load.load() == 2);
+  REQUIRE(object_tree.SetObject("stats.requests", 100.0f));
+  REQUIRE(!object_tree.SetObject("stats.requests", std::string("many")));
+  REQUIRE(!object_tree.Emplace<std::string>("stats.requests", "many"));
+  REQUIRE(object_tree.Emplace<int>("stats.requests", 100));
+  REQUIRE(requests.load() == 100);
+  REQUIRE(object_tree.GetObject<std::int64_t>("stats.requests") == 100);
+
+  // Leaves that hold another number keep their value, leaves that are atomics of another type are left alone.
+  object_tree.SetObject("stats.seeded", 5);
+  object_tree.RegisterColumn<float>();
+  object_tree.SetObject("stats.ratio", 1.5f);
+  REQUIRE(object_tree.GetAtomic<std::int64_t>("stats.seeded").load() == 5);
+  REQUIRE(object_tree.GetAtomic<double>("stats.ratio").load() == 1.5);
+  // Readers of the type the leaf held before see the converted atomic value.
+  object_tree.SetObject("stats.seeded", 6);
+  REQUIRE(object_tree.GetObject<int>("stats.seeded") == 6);
+  std::vector<int> seeded;
+  std::vector<std::string> seeded_leaves{"seeded"};
+  REQUIRE(object_tree.GetObjects("stats", seeded_leaves, seeded) == 1);
+  REQUIRE(seeded[0] == 6);
+  int seeded_value = 0;
+  REQUIRE(object_tree.Read<int>("stats.seeded", [&seeded_value](const int &value) { seeded_value = value; }));
+  REQUIRE(seeded_value == 6);
+  REQUIRE(object_tree.GetObject<float>("stats.ratio") == 1.5f);
+  REQUIRE(object_tree.Summarize<float>("stats").count == 0);
+  generation = object_tree.generation();
+  REQUIRE(!object_tree.GetAtomic<double>("stats.requests"));
+  REQUIRE(object_tree.GetAtomic<std::int64_t>("stats.seeded").load() == 6);
+  REQUIRE(object_tree.generation() == generation);
+  requests.fetch_add(1);
+  REQUIRE(object_tree.GetObject<std::int64_t>("stats.requests") == 101);
+  object_tree.SetObject("stats.requests", std::int64_t(100));
+
+  // Concurrent updates take no tree lock and lose nothing.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&object_tree]() {
+      auto counter = object_tree.GetAtomic<std::int64_t>("stats.requests");
+      for (int i = 0; i < 10000; i++) counter.fetch_add(1);
+    });
+  }
+  {
+    // The updates need no write lock, so they go on while this thread holds the read lock.
+    ReadLock l(object_tree.mutex());
+    for (auto &thread : threads) thread.join();
+  }
+  REQUIRE(object_tree.GetObject<std::int64_t>("stats.requests") == 40100);
+
+  // A removed leaf detaches its handles safely.
+  object_tree.remove("stats");
+  requests.fetch_add(1);
+  REQUIRE(requests.load() == 40101);
+  REQUIRE(!object_tree.exists("stats.requests"));
+}
+
+namespace {
+
+/**
+ * @brief A large object that counts its copies and moves.
+ */
+struct CountedObject {
+  static int copies;
+  static int moves;
+  std::vector<int> values;
+
+  CountedObject(std::size_t size, int value) : values(size, value) {}
+  CountedObject(const CountedObject &other) : values(other.values) { copies++; }
+  CountedObject(CountedObject &&other) noexcept : values(std::move(other.values)) { moves++; }
+};
+
+int CountedObject::copies = 0;
+int CountedObject::moves = 0;
+
+}
+
+TEST_CASE("ObjectTree moves and emplace") {
+  ObjectPropertyTree object_tree;
+
+  // An rvalue is moved into the node once, its buffer is not copied.
+  CountedObject object(1000, 7);
+  const int *buffer = object.values.data();
+  object_tree.SetObject("objects.moved", std::move(object));
+  REQUIRE(CountedObject::copies == 0);
+  REQUIRE(CountedObject::moves == 1);
+  CountedObject *stored = object_tree.GetNode("objects.moved")->data().get<CountedObject>();
+  REQUIRE(stored->values.data() == buffer);
+
+  // Emplace constructs the object in the node.
+  REQUIRE(object_tree.Emplace<CountedObject>("objects.emplaced", 1000, 8));
+  REQUIRE(CountedObject::copies == 0);
+  REQUIRE(CountedObject::moves == 1);
+  REQUIRE(object_tree.GetNode("objects.emplaced")->data().get<CountedObject>()->values[999] == 8);
+  REQUIRE(!object_tree.Emplace<CountedObject>("", 1, 1));
+
+  // Emplace by handle replaces the object in place.
+  NodeHandle handle = object_tree.Resolve("objects.moved");
+  REQUIRE(object_tree.Emplace<CountedObject>(handle, 10, 9));
+  REQUIRE(object_tree.GetNode("objects.moved")->data().get<CountedObject>()->values.size() == 10);
+  REQUIRE(CountedObject::copies == 0);
+
+  // An lvalue is copied once.
+  CountedObject copied(10, 1);
+  object_tree.SetObject("objects.copied", copied);
+  REQUIRE(CountedObject::copies == 1);
+  REQUIRE(CountedObject::moves == 1);
+
+  // SetData moves an rvalue value into the node.
+  ObjectValue value(CountedObject(1000, 3));
+  buffer = value.get<CountedObject>()->values.data();
+  object_tree.SetData("objects.value", std::move(value));
+  REQUIRE(value.empty());
+  REQUIRE(object_tree.GetNode("objects.value")->data().get<CountedObject>()->values.data() == buffer);
+  REQUIRE(CountedObject::copies == 1);
+
+  // Emplaced columns and atomic leaves are stored like SetObject.
+  object_tree.RegisterColumn<double>();
+  AtomicLeaf<std::int64_t> counter = object_tree.GetAtomic<std::int64_t>("stats.count");
+  REQUIRE(object_tree.Emplace<double>("stats.load", 0.5));
+  REQUIRE(object_tree.Emplace<std::int64_t>("stats.count", 3));
+  REQUIRE(object_tree.Summarize<double>("stats").sum == 0.5);
+  REQUIRE(counter.load() == 3);
+}
+
+TEST_CASE("ObjectTree read and modify") {
+  ObjectPropertyTree object_tree;
+  object_tree.Emplace<CountedObject>("objects.large", 1000, 2);
+  object_tree.SetObject("objects.name", std::string("large"));
+  int copies = CountedObject::copies;
+
+  // Reads see the stored object itself.
+  const int *buffer = object_tree.GetNode("objects.large")->data().get<CountedObject>()->values.data();
+  long sum = 0;
+  REQUIRE(object_tree.Read<CountedObject>("objects.large", [&sum, buffer](const CountedObject &object) {
+    REQUIRE(object.values.data() == buffer);
+    for (int value : object.values) sum += value;
+  }));
+  REQUIRE(sum == 2000);
+  REQUIRE(!object_tree.Read<CountedObject>("objects.name", [](const CountedObject &) { FAIL(); }));
+  REQUIRE(!object_tree.Read<CountedObject>("objects.missing", [](const CountedObject &) { FAIL(); }));
+
+  // Modifications are made in place, stamped and published.
+  std::uint64_t generation = object_tree.generation();
+  REQUIRE(object_tree.Modify<CountedObject>("objects.large", [](CountedObject &object) {
+    object.values.push_back(3);
+  }));
+  REQUIRE(object_tree.generation() == generation + 1);
+  REQUIRE(object_tree.GetNode("objects.large")->version() == generation + 1);
+  REQUIRE(!object_tree.Modify<int>("objects.large", [](int &) { FAIL(); }));
+  REQUIRE(!object_tree.Modify<int>("objects.missing", [](int &) { FAIL(); }));
+  REQUIRE(object_tree.generation() == generation + 1);
+  REQUIRE(CountedObject::copies == copies);
+
+  // Handles, columns and atomic leaves.
+  NodeHandle handle = object_tree.Resolve("objects.large");
+  std::size_t size = 0;
+  REQUIRE(object_tree.Read<CountedObject>(handle, [&size](const CountedObject &object) {
+    size = object.values.size();
+  }));
+  REQUIRE(size == 1001);
+  object_tree.RegisterColumn<double>();
+  object_tree.SetObject("stats.load", 0.5);
+  REQUIRE(object_tree.Modify<double>("stats.load", [](double &load) { load *= 3; }));
+  REQUIRE(object_tree.Summarize<double>("stats").sum == 1.5);
+  object_tree.GetAtomic<std::int64_t>("stats.count").store(4);
+  std::int64_t count = 0;
+  REQUIRE(object_tree.Read<std::int64_t>("stats.count", [&count](const std::int64_t &value) { count = value; }));
+  REQUIRE(count == 4);
+  REQUIRE(!object_tree.Modify<std::int64_t>("stats.count", [](std::int64_t &) { FAIL(); }));
+}
@@ -0,0 +1,66 @@
+#include "catch.hpp"
+#include "object_value.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST_CASE("ObjectValue") {
+  ObjectValue value;
+  REQUIRE(value.empty());
+  REQUIRE(value.get<int>() == nullptr);
+
+  // Scalars and shared pointers are stored inline, larger objects on the heap.
+  REQUIRE(ObjectValue::IsInline<int>::value);
+  REQUIRE(ObjectValue::IsInline<double>::value);
+  REQUIRE(ObjectValue::IsInline<std::shared_ptr<std::string>>::value);
+  REQUIRE(!ObjectValue::IsInline<std::string>::value);
+
+  value = 42;
+  REQUIRE(value.is<int>());
+  REQUIRE(!value.is<long>());
+  REQUIRE(*value.get<int>() == 42);
+  REQUIRE(value.get<double>() == nullptr);
+  REQUIRE(value.type_id() == TypeId::Of<int>());
+  REQUIRE(ObjectValue().type_id() == TypeId::Of<void>());
+
+  value = std::string("forty two");
+  REQUIRE(*value.get<std::string>() == "forty two");
+  REQUIRE(value.get<int>() == nullptr);
+
+  // Copies are deep, moves leave the source empty.
+  ObjectValue copy(value);
+  *copy.get<std::string>() += "!";
+  REQUIRE(*value.get<std::string>() == "forty two");
+  ObjectValue moved(std::move(copy));
+  REQUIRE(copy.empty());
+  REQUIRE(*moved.get<std::string>() == "forty two!");
+
+  // Inline values with destructors are destroyed.
+  auto shared = std::make_shared<int>(7);
+  value = shared;
+  REQUIRE(shared.use_count() == 2);
+  ObjectValue shared_copy = value;
+  REQUIRE(shared.use_count() == 3);
+  value = 1.5;
+  shared_copy.clear();
+  REQUIRE(shared.use_count() == 1);
+  REQUIRE(*value.get<double>() == 1.5);
+
+  // Values in containers survive reallocation.
+  std::vector<ObjectValue> values;
+  for (int i = 0; i < 100; i++) {
+    if (i % 2) {
+      values.emplace_back(std::vector<int>(3, i));
+    } else {
+      values.emplace_back(i);
+    }
+  }
+  REQUIRE(*values[40].get<int>() == 40);
+  REQUIRE((*values[41].get<std::vector<int>>())[2] == 41);
+
+  // Emplace constructs in place, inline or on the heap.
+  REQUIRE(value.emplace<std::string>(3, 'x') == "xxx");
+  REQUIRE(*value.get<std::string>() == "xxx");
+  value.emplace<long>(5L);
+  REQUIRE(*value.get<long>() == 5);
+}
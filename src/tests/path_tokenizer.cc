@@ -0,0 +1,46 @@
+#include "catch.hpp"
+#include "path_tokenizer.h"
+#include "node.h"
+
+TEST_CASE("PathTokenizer") {
+  std::string path = "This.is..path.one.";
+  std::vector<boost::string_view> segments;
+  std::vector<boost::string_view> segments_test{"This", "is", "path", "one"};
+
+  // Segments are views into the original string.
+  PathTokenizer tokenizer(path);
+  for (auto segment : tokenizer) {
+    REQUIRE(segment.data() >= path.data());
+    REQUIRE(segment.data() < path.data() + path.size());
+    segments.push_back(segment);
+  }
+  REQUIRE(segments == segments_test);
+  REQUIRE(tokenizer.size() == 4);
+  REQUIRE(!tokenizer.empty());
+  REQUIRE(PathTokenizer("...").empty());
+  REQUIRE(PathTokenizer("").size() == 0);
+
+  // Multiple separators.
+  REQUIRE(PathTokenizer("a/b.c", "./").size() == 3);
+
+  // Spans over segments.
+  PathSpan<boost::string_view> span(segments);
+  REQUIRE(span.size() == 4);
+  REQUIRE(span.front() == "This");
+  REQUIRE(span.back() == "one");
+  REQUIRE(span.subspan(1, 2).size() == 2);
+  REQUIRE(span.subspan(1, 2)[0] == "is");
+  REQUIRE(span.subspan(3).size() == 1);
+  REQUIRE(span.subspan(5).empty());
+
+  // Nodes consume tokenizers and spans directly.
+  Node<std::string, int> root("root");
+  Node<std::string, int> *node = root.Add(tokenizer);
+  REQUIRE(node->name() == "one");
+  REQUIRE(root.Find(span) == node);
+  REQUIRE(root.Find(span.subspan(0, 2)) == root.Find("This.is"));
+  REQUIRE(root.Find(span.subspan(1)) == nullptr);
+  REQUIRE(root.Find("") == nullptr);
+  root.Remove(span.subspan(0, 1));
+  REQUIRE(root.children().empty());
+}
@@ -0,0 +1,74 @@
+#include "catch.hpp"
+#include "object_property_tree.h"
+#include <string>
+
+TEST_CASE("PointerPool") {
+  PointerPool::Owner pool = PointerPool::Create();
+  REQUIRE(pool->capacity() == 0);
+
+  // Blocks of a size class are carved from a chunk and reused once freed.
+  void *first = pool->Allocate(24, 8);
+  void *second = pool->Allocate(32, 8);
+  REQUIRE(pool->size() == 2);
+  REQUIRE(pool->capacity() > 0);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(second) % 16 == 0);
+  pool->Deallocate(first, 24, 8);
+  REQUIRE(pool->size() == 1);
+  REQUIRE(pool->Allocate(17, 8) == first);
+  pool->Deallocate(first, 17, 8);
+  pool->Deallocate(second, 32, 8);
+
+  // Large blocks come from the heap.
+  std::size_t capacity = pool->capacity();
+  void *large = pool->Allocate(4096, 8);
+  REQUIRE(pool->size() == 1);
+  REQUIRE(pool->capacity() == capacity);
+  pool->Deallocate(large, 4096, 8);
+  REQUIRE(pool->size() == 0);
+
+  // Shared pointers made with the allocator keep the pool alive after it is closed.
+  std::shared_ptr<std::string> pointer =
+      std::allocate_shared<std::string>(PoolAllocator<std::string>(pool.get()), "pooled");
+  REQUIRE(pool->size() == 1);
+  pool.reset();
+  REQUIRE(*pointer == "pooled");
+  pointer.reset();
+}
+
+TEST_CASE("ObjectTree pointers") {
+  std::shared_ptr<std::string> escaped;
+  {
+    ObjectPropertyTree object_tree;
+
+    // An existing shared pointer is stored as it is.
+    auto shared = std::make_shared<std::string>("shared");
+    object_tree.SetPointer("pointers.shared", shared);
+    REQUIRE(shared.use_count() == 2);
+    REQUIRE(object_tree.GetPointer<std::string>("pointers.shared") == shared.get());
+
+    // Objects made in the pool share their block with the control block and return it when released.
+    REQUIRE(object_tree.EmplacePointer<std::string>("pointers.pooled", "pooled"));
+    REQUIRE(object_tree.pointer_pool().size() == 1);
+    REQUIRE(*object_tree.GetPointer<std::string>("pointers.pooled") == "pooled");
+    NodeHandle handle = object_tree.Resolve("pointers");
+    REQUIRE(object_tree.EmplacePointer<std::string>(handle, "replaced"));
+    REQUIRE(object_tree.EmplacePointer<std::string>("pointers.pooled", 3, 'x'));
+    REQUIRE(object_tree.pointer_pool().size() == 2);
+    REQUIRE(*object_tree.GetPointer<std::string>("pointers") == "replaced");
+    object_tree.remove("pointers.pooled");
+    REQUIRE(object_tree.pointer_pool().size() == 1);
+    REQUIRE(!object_tree.EmplacePointer<std::string>("", "none"));
+
+    // Unowned pointers are returned as they are and not deleted with the node.
+    std::string unowned("unowned");
+    object_tree.SetUnownedPointer("pointers.unowned", &unowned);
+    REQUIRE(object_tree.GetPointer<std::string>("pointers.unowned") == &unowned);
+    object_tree.remove("pointers.unowned");
+    REQUIRE(unowned == "unowned");
+
+    // Pooled objects may outlive the tree.
+    escaped = *object_tree.GetNode("pointers")->data().get<std::shared_ptr<std::string>>();
+  }
+  REQUIRE(*escaped == "replaced");
+  escaped.reset();
+}
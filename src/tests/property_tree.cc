@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include "property_tree.h"
+#include <boost/thread.hpp>
 
 TEST_CASE("PropertyTree") {
   PropertyTree<std::string, int> tree;
@@ -24,7 +25,7 @@ TEST_CASE("PropertyTree") {
   REQUIRE(tree.ListChildren("child_a", children) == 1);
 
   // Getting a node. Root:
-  Node<std::string, int> node = tree.GetRootNode();
+  Node<std::string, int> &node = tree.GetRootNode();
   REQUIRE(node.HasChild("child_a"));
   REQUIRE(node.GetChild("child_a")->HasChild("child_1"));
   // Child node:
@@ -45,4 +46,142 @@ TEST_CASE("PropertyTree") {
   REQUIRE(tree.changed());
   tree.ClearChanged();
   REQUIRE(tree.ListChildren(children) == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("PropertyTree misses") {
+  PropertyTree<std::string, int> tree;
+  std::vector<std::string> children;
+  int data = 0;
+
+  tree.SetData("config.sensor.value", 1);
+  auto *sensor = tree.GetNode("config.sensor");
+  std::size_t root_children = tree.GetRootNode().children().size();
+  std::size_t sensor_children = sensor->children().size();
+
+  // Lookups of missing paths leave the child maps alone.
+  for (int i = 0; i < 10000; i++) {
+    std::string name = std::to_string(i);
+    REQUIRE(!tree.exists("missing" + name));
+    REQUIRE(!tree.exists("config.sensor.missing" + name));
+    REQUIRE(tree.Find("config.missing" + name + ".value") == nullptr);
+    tree.GetData("config.sensor.value.missing" + name, data);
+    REQUIRE(!sensor->HasChild("missing" + name));
+    REQUIRE(sensor->GetChild("missing" + name) == nullptr);
+  }
+  REQUIRE(tree.GetRootNode().children().size() == root_children);
+  REQUIRE(sensor->children().size() == sensor_children);
+  REQUIRE(tree.ListChildren("config", children) == 1);
+
+  // Compact purges null entries.
+  sensor->children()["null_entry"] = nullptr;
+  tree.GetRootNode().children()["null_entry"] = nullptr;
+  REQUIRE(tree.compact() == 2);
+  REQUIRE(tree.GetRootNode().children().size() == root_children);
+  REQUIRE(sensor->children().size() == sensor_children);
+  REQUIRE(tree.compact() == 0);
+  tree.GetData("config.sensor.value", data);
+  REQUIRE(data == 1);
+}
+
+TEST_CASE("PropertyTree concurrent writers") {
+  PropertyTree<std::string, int> tree;
+  std::vector<std::string> children;
+  std::uint64_t generation = tree.generation();
+
+  // Writers upsert the same paths while readers look them up, run with -DENABLE_TSAN=ON to check for races.
+  boost::thread_group threads;
+  for (int t = 0; t < 4; t++) {
+    threads.create_thread([&tree, t]() {
+      std::vector<std::string> names;
+      int data = 0;
+      for (int i = 0; i < 1000; i++) {
+        std::string path = "unit" + std::to_string(i % 10) + ".value";
+        if (t % 2) {
+          tree.SetData(path, i);
+        } else {
+          tree.GetData(path, data);
+          tree.exists(path);
+          tree.ListChildren("unit0", names);
+        }
+        if (i % 100 == 0) tree.ClearChanged();
+      }
+    });
+  }
+  threads.join_all();
+
+  // Each path was created once and every write advanced the generation.
+  REQUIRE(tree.ListChildren(children) == 10);
+  REQUIRE(tree.generation() == generation + 2000);
+  tree.SetData("unit0.value", 0);
+  REQUIRE(tree.changed());
+  tree.ClearChanged();
+  REQUIRE(!tree.changed());
+}
+
+TEST_CASE("PropertyTree change tracking") {
+  PropertyTree<std::string, int> tree;
+  std::vector<NodePath<std::string>> changed;
+
+  tree.SetData("config.unit_a.setting", 1);
+  tree.SetData("config.unit_b.setting", 2);
+  tree.SetData("sensors.value", 3);
+  auto *unit_a = tree.GetNode("config.unit_a.setting");
+  REQUIRE(unit_a->version() == tree.generation() - 2);
+  REQUIRE(tree.GetRootNode().subtree_version() == tree.generation());
+  REQUIRE(tree.GetNode("config")->subtree_version() == tree.generation() - 1);
+  REQUIRE(tree.GetNode("config")->version() == 0);
+
+  // Only the changed nodes are listed.
+  std::uint64_t generation = tree.ListChanged(0, changed);
+  REQUIRE(changed.size() == 3);
+  REQUIRE(tree.ListChanged(generation, changed) == generation);
+  REQUIRE(changed.empty());
+
+  tree.SetData("config.unit_b.setting", 4);
+  tree.remove("sensors.value");
+  generation = tree.ListChanged(generation, changed);
+  REQUIRE(changed.size() == 2);
+  NodePath<std::string> path;
+  path.ToList("config.unit_b.setting");
+  REQUIRE(changed[0] == path);
+  path.clear();
+  path.push_back("sensors");
+  REQUIRE(changed[1] == path);
+
+  // Clearing the tree changes the root.
+  tree.clear();
+  tree.ListChanged(generation, changed);
+  REQUIRE(changed.size() == 1);
+  REQUIRE(changed[0].empty());
+}
+
+TEST_CASE("PropertyTree multi-get") {
+  PropertyTree<std::string, int> tree;
+  tree.SetData("session.1.user", 1);
+  tree.SetData("session.1.expires", 2);
+  tree.SetData("session.1.limits.rate", 3);
+  tree.SetData("session.2.user", 4);
+  std::vector<int> data;
+
+  // Full paths, in any order, with misses in between.
+  std::vector<std::string> paths{"session.1.user", "session.1.limits.rate", "session.1.missing", "session.2.user",
+                                 "", "session.1.expires", "other.user"};
+  REQUIRE(tree.GetData(paths, data) == 4);
+  REQUIRE(data == std::vector<int>({1, 3, 0, 4, 0, 2, 0}));
+
+  // Leaves relative to a prefix.
+  std::vector<std::string> leaves{"user", "limits.rate", "limits.missing", "expires"};
+  REQUIRE(tree.GetData("session.1", leaves, data) == 3);
+  REQUIRE(data == std::vector<int>({1, 3, 0, 2}));
+  REQUIRE(tree.GetData("session.3", leaves, data) == 0);
+  REQUIRE(data == std::vector<int>(4, 0));
+
+  // Other path types.
+  std::vector<CompiledPath> compiled{CompiledPath("session.2.user"), CompiledPath("session.1.user")};
+  REQUIRE(tree.GetData(compiled, data) == 2);
+  REQUIRE(data == std::vector<int>({4, 1}));
+  std::vector<NodePath<std::string>> node_paths(1);
+  node_paths[0].ToList("limits.rate");
+  REQUIRE(tree.GetData(std::string("session.1"), node_paths, data) == 1);
+  REQUIRE(data[0] == 3);
+}
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include "small_vector_map.h"
+#include "atom_property_tree.h"
+#include <map>
+
+TEST_CASE("SmallVectorMap") {
+  SmallVectorMap<std::string, int, 4> map;
+  std::vector<std::string> keys;
+
+  // Empty maps hold no array, so leaves stay small.
+  REQUIRE(sizeof(map) < sizeof(std::map<std::string, int>));
+
+  // Entries are kept sorted.
+  REQUIRE(map.empty());
+  REQUIRE(map.emplace("d", 4).second);
+  REQUIRE(map.emplace("b", 2).second);
+  REQUIRE(map.emplace("a", 1).second);
+  REQUIRE(!map.emplace("b", 3).second);
+  map["c"] = 3;
+  REQUIRE(map.size() == 4);
+  REQUIRE(!map.spilled());
+  for (auto &entry : map) {
+    keys.push_back(entry.first);
+  }
+  REQUIRE(keys == std::vector<std::string>{"a", "b", "c", "d"});
+  REQUIRE(map.find(boost::string_view("c"))->second == 3);
+  REQUIRE(map.find("e") == map.end());
+
+  // Erase keeps the order.
+  REQUIRE(map.erase("b") == 1);
+  REQUIRE(map.erase("b") == 0);
+  keys.clear();
+  for (auto &entry : map) {
+    keys.push_back(entry.first);
+  }
+  REQUIRE(keys == std::vector<std::string>{"a", "c", "d"});
+
+  // Spill beyond the array capacity.
+  for (int i = 0; i < 100; i++) {
+    map.emplace("key" + std::to_string(i), i);
+  }
+  REQUIRE(map.spilled());
+  REQUIRE(map.size() == 103);
+  REQUIRE(map.find("a")->second == 1);
+  REQUIRE(map.find("key42")->second == 42);
+  std::size_t visited = 0;
+  for (auto i = map.begin(); i != map.end(); i++) {
+    visited++;
+  }
+  REQUIRE(visited == 103);
+
+  // Copy, move and clear.
+  SmallVectorMap<std::string, int, 4> copy(map);
+  REQUIRE(copy.find("key99")->second == 99);
+  SmallVectorMap<std::string, int, 4> moved(std::move(copy));
+  REQUIRE(moved.size() == 103);
+  REQUIRE(copy.empty());
+  moved.clear();
+  REQUIRE(!moved.spilled());
+  moved.emplace("x", 1);
+  SmallVectorMap<std::string, int, 4> small_copy;
+  small_copy = moved;
+  REQUIRE(small_copy.find("x")->second == 1);
+  small_copy.erase(small_copy.find("x"));
+  REQUIRE(small_copy.empty());
+
+  // A tree with narrow nodes.
+  AtomPropertyTree<int, SmallVectorChildren<4>> tree;
+  std::vector<KeyAtom> children;
+  tree.SetData("config.sensor.value", 1);
+  tree.SetData("config.sensor.unit", 2);
+  for (int i = 0; i < 10; i++) {
+    tree.SetData("config.sensor" + std::to_string(i), i);
+  }
+  int data = 0;
+  tree.GetData("config.sensor.unit", data);
+  REQUIRE(data == 2);
+  tree.GetData("config.sensor7", data);
+  REQUIRE(data == 7);
+  REQUIRE(tree.ListChildren("config.sensor", children) == 2);
+  REQUIRE(tree.ListChildren("config", children) == 11);
+  tree.remove("config.sensor.unit");
+  REQUIRE(!tree.exists("config.sensor.unit"));
+  REQUIRE(tree.exists("config.sensor.value"));
+}
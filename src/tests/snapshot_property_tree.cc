@@ -0,0 +1,70 @@
+#include "catch.hpp"
+#include "snapshot_property_tree.h"
+#include <boost/thread.hpp>
+
+TEST_CASE("SnapshotPropertyTree") {
+  SnapshotPropertyTree<std::string, int> tree;
+  std::vector<std::string> children;
+  int data = 0;
+
+  // Adding and reading nodes
+  tree.SetData("config.unit_a.setting", 1);
+  tree.SetData(CompiledPath("config.unit_b.setting"), 2);
+  REQUIRE(tree.changed());
+  REQUIRE(tree.exists("config.unit_a"));
+  REQUIRE(tree.GetData("config.unit_b.setting", data));
+  REQUIRE(data == 2);
+  REQUIRE(!tree.GetData("config.unit_c", data));
+
+  // A snapshot keeps its version.
+  auto before = tree.snapshot();
+  tree.SetData("config.unit_a.setting", 3);
+  tree.remove("config.unit_b");
+  tree.remove("config.missing");
+  auto after = tree.snapshot();
+  REQUIRE(after.version() == before.version() + 2);
+  REQUIRE(before.GetData("config.unit_a.setting", data));
+  REQUIRE(data == 1);
+  REQUIRE(before.ListChildren("config", children) == 2);
+  REQUIRE(after.GetData("config.unit_a.setting", data));
+  REQUIRE(data == 3);
+  REQUIRE(after.ListChildren("config", children) == 1);
+
+  // Only the path to the change is copied.
+  tree.SetData("sensors.value", 4);
+  REQUIRE(tree.snapshot().Find("config") == after.Find("config"));
+  REQUIRE(tree.snapshot().root() != after.root());
+
+  tree.clear();
+  REQUIRE(tree.snapshot().ListChildren(children) == 0);
+  REQUIRE(after.exists("config.unit_a.setting"));
+
+  // Readers hold snapshots while a writer publishes new versions.
+  boost::thread_group threads;
+  std::atomic<bool> done(false);
+  std::atomic<int> torn(0);
+  for (int t = 0; t < 3; t++) {
+    threads.create_thread([&tree, &done, &torn]() {
+      while (!done) {
+        auto snapshot = tree.snapshot();
+        int a = -1;
+        int b = -1;
+        snapshot.GetData("pair.a", a);
+        snapshot.GetData("pair.b", b);
+        int again = -1;
+        snapshot.GetData("pair.a", again);
+        // pair.a is set first, so a snapshot holds either equal values or a one ahead.
+        if ((a != b && a != b + 1) || again != a) torn++;
+      }
+    });
+  }
+  for (int i = 0; i < 2000; i++) {
+    tree.SetData("pair.a", i);
+    auto snapshot = tree.snapshot();
+    tree.SetData("pair.b", i);
+    REQUIRE(snapshot.GetData("pair.b", data) == (i != 0));
+  }
+  done = true;
+  threads.join_all();
+  REQUIRE(torn == 0);
+}
@@ -0,0 +1,93 @@
+#include "catch.hpp"
+#include "property_tree.h"
+#include <memory>
+#include <thread>
+
+TEST_CASE("SubscriptionManager") {
+  PropertyTree<std::string, int> tree;
+  std::vector<ChangeEvent> events;
+  int batches = 0;
+
+  // Nothing to pay without subscribers.
+  REQUIRE(!tree.subscriptions().active());
+  tree.SetData("sensors.a.value", 0);
+
+  std::size_t id = tree.Subscribe("sensors.*.value", [&events, &batches](const std::vector<ChangeEvent> &batch) {
+    batches++;
+    events.insert(events.end(), batch.begin(), batch.end());
+  });
+  REQUIRE(tree.subscriptions().active());
+
+  // A burst of updates to one leaf is coalesced.
+  for (int i = 0; i < 10000; i++) {
+    tree.SetData("sensors.a.value", i);
+  }
+  tree.SetData("config.a.value", 1);
+  tree.subscriptions().Flush();
+  REQUIRE(batches >= 1);
+  REQUIRE(events.size() == static_cast<std::size_t>(batches));
+  REQUIRE(events.back().path == "sensors.a.value");
+  REQUIRE(events.back().kind == ChangeEvent::SET);
+  REQUIRE(events.back().generation == tree.generation() - 1);
+
+  // Descendants of a match and removals of its ancestors are delivered, in the order they were made.
+  events.clear();
+  tree.SetData(CompiledPath("sensors.b.value.raw"), 1);
+  tree.remove("sensors");
+  tree.subscriptions().Flush();
+  REQUIRE(events.size() == 2);
+  REQUIRE(events[0].path == "sensors.b.value.raw");
+  REQUIRE(events[1].path == "sensors");
+  REQUIRE(events[1].kind == ChangeEvent::REMOVED);
+  REQUIRE(events[0].generation < events[1].generation);
+
+  // The changes of a batch share a generation and keep their order.
+  events.clear();
+  WriteBatch<std::string, int> batch;
+  batch.Set("sensors.c.value", 1);
+  batch.Remove("sensors");
+  tree.Apply(batch);
+  tree.subscriptions().Flush();
+  REQUIRE(events.size() == 2);
+  REQUIRE(events[0].kind == ChangeEvent::SET);
+  REQUIRE(events[1].kind == ChangeEvent::REMOVED);
+
+  events.clear();
+  tree.clear();
+  tree.subscriptions().Flush();
+  REQUIRE(events.size() == 1);
+  REQUIRE(events[0].path.empty());
+
+  tree.Unsubscribe(id);
+  REQUIRE(!tree.subscriptions().active());
+  events.clear();
+  tree.SetData("sensors.a.value", 1);
+  tree.subscriptions().Flush();
+  REQUIRE(events.empty());
+}
+
+TEST_CASE("SubscriptionManager teardown") {
+  // A callback that is reading the tree when it is destroyed finishes before the nodes go.
+  std::atomic<bool> reading{false};
+  std::atomic<int> found{0};
+  std::unique_ptr<PropertyTree<std::string, int>> tree(new PropertyTree<std::string, int>());
+  PropertyTree<std::string, int> *reader = tree.get();
+  tree->Subscribe("sensors", [reader, &reading, &found](const std::vector<ChangeEvent> &) {
+    reading = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    if (reader->exists("sensors.a")) found++;
+  });
+  tree->SetData("sensors.a", 1);
+  while (!reading) std::this_thread::yield();
+  tree.reset();
+  REQUIRE(found == 1);
+
+  // Stopped managers deliver nothing more.
+  SubscriptionManager manager;
+  int batches = 0;
+  manager.Subscribe("a", [&batches](const std::vector<ChangeEvent> &) { batches++; });
+  manager.Stop();
+  manager.Publish("a", ChangeEvent::SET, 1);
+  manager.Flush();
+  REQUIRE(batches == 0);
+}
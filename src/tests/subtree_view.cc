@@ -0,0 +1,62 @@
+#include "catch.hpp"
+#include "subtree_view.h"
+
+TEST_CASE("SubtreeView") {
+  ObjectPropertyTree tree;
+  tree.SetObject("tenants.acme.name", std::string("Acme"));
+
+  SubtreeView acme(tree, "tenants.acme");
+  REQUIRE(acme.exists());
+  REQUIRE(acme.handle() == tree.Resolve("tenants.acme"));
+  REQUIRE(acme.GetObject<std::string>("name") == "Acme");
+  REQUIRE(acme.SetObject("limits.quota", 10));
+  REQUIRE(tree.GetObject<int>("tenants.acme.limits.quota") == 10);
+  ObjectPath quota_path;
+  quota_path.ToList("limits.quota");
+  REQUIRE(acme.GetObject<int>(quota_path) == 10);
+  REQUIRE(acme.GetObject<int>("limits.missing") == 0);
+  REQUIRE(!acme.SetObject("", 1));
+
+  tree.SetPointer("tenants.acme.owner", new std::string("Wile"));
+  REQUIRE(*acme.GetPointer<std::string>("owner") == "Wile");
+  REQUIRE(acme.GetPointer<std::string>("name") == nullptr);
+
+  std::vector<std::string> children;
+  REQUIRE(acme.ListChildren(children, true) == 3);
+  REQUIRE(children == std::vector<std::string>({"limits", "name", "owner"}));
+  REQUIRE(acme.ListChildren("limits", children) == 1);
+  REQUIRE(children[0] == "quota");
+
+  // Views on missing nodes create them, nested views are relative to their parent.
+  SubtreeView initech(tree, "tenants.initech");
+  REQUIRE(tree.exists("tenants.initech"));
+  SubtreeView limits = acme.View("limits");
+  REQUIRE(limits.GetObject<int>("quota") == 10);
+  REQUIRE(limits.SetObject("users", 5));
+  REQUIRE(tree.GetObject<int>("tenants.acme.limits.users") == 5);
+
+  // Writes through a view are stamped and published with their full path.
+  std::uint64_t generation = tree.generation();
+  REQUIRE(acme.SetObject("limits.quota", 20));
+  std::vector<ObjectPath> changed;
+  tree.ListChanged(generation, changed);
+  REQUIRE(changed.size() == 1);
+  REQUIRE(PathString(changed[0]) == "tenants.acme.limits.quota");
+
+  // Removing the node makes the view stale, also when the prefix is created again.
+  tree.remove("tenants.acme");
+  REQUIRE(!acme.exists());
+  REQUIRE(!limits.exists());
+  REQUIRE(acme.GetObject<int>("limits.quota") == 0);
+  REQUIRE(!acme.SetObject("limits.quota", 30));
+  REQUIRE(acme.ListChildren(children) == 0);
+  REQUIRE(!acme.View("limits").exists());
+  tree.SetObject("tenants.acme.limits.quota", 40);
+  REQUIRE(!acme.exists());
+  REQUIRE(initech.exists());
+
+  SubtreeView empty;
+  REQUIRE(!empty.exists());
+  REQUIRE(!empty.SetObject("a", 1));
+  REQUIRE(empty.GetPointer<int>("a") == nullptr);
+}
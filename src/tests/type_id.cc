@@ -0,0 +1,32 @@
+#include "catch.hpp"
+#include "type_id.h"
+#include <map>
+#include <string>
+
+namespace {
+struct Sensor {};
+}
+
+TEST_CASE("TypeId") {
+  REQUIRE(TypeId::Of<int>() == TypeId::Of<int>());
+  REQUIRE(TypeId::Of<int>() != TypeId::Of<long>());
+  REQUIRE(TypeId::Of<int>() != TypeId::Of<unsigned>());
+  REQUIRE(TypeId::Of<const int &>() == TypeId::Of<int>());
+  REQUIRE(TypeId::Of<int *>() != TypeId::Of<int>());
+
+  // Ids are usable at compile time.
+  constexpr TypeId id = TypeId::Of<Sensor>();
+  static_assert(id == TypeId::Of<Sensor>(), "ids must compare at compile time");
+
+  // Names are for diagnostics, they need no RTTI.
+  REQUIRE(TypeId::Of<int>().name() == "int");
+  REQUIRE(TypeId::Of<Sensor>().name().to_string().find("Sensor") != std::string::npos);
+  REQUIRE(TypeId::Of<std::map<int, int>>().name().to_string().find("map") != std::string::npos);
+
+  // Ids can be ordered and hashed.
+  std::map<TypeId, int> types;
+  types[TypeId::Of<int>()] = 1;
+  types[TypeId::Of<double>()] = 2;
+  REQUIRE(types[TypeId::Of<int>()] == 1);
+  REQUIRE(TypeId::Of<int>().hash() == TypeId::Of<int>().hash());
+}
@@ -0,0 +1,68 @@
+#include "catch.hpp"
+#include "property_tree.h"
+
+TEST_CASE("WriteBatch") {
+  PropertyTree<std::string, int> tree;
+  std::vector<std::string> children;
+  std::vector<ChangeEvent> events;
+  int data = 0;
+
+  tree.SetData("old.value", 1);
+  tree.Subscribe("*", [&events](const std::vector<ChangeEvent> &batch) {
+    events.insert(events.end(), batch.begin(), batch.end());
+  });
+
+  WriteBatch<std::string, int> batch;
+  batch.Set("msg.b.value", 2)
+      .Set(CompiledPath("msg.a.value"), 1)
+      .Set("msg.b.value", 3)
+      .Remove("old")
+      .Set("old.value", 4)
+      .Remove("missing");
+  REQUIRE(batch.size() == 6);
+  std::uint64_t generation = tree.generation();
+  tree.Apply(batch);
+
+  // Applied in order where it matters, under one generation.
+  REQUIRE(tree.generation() == generation + 1);
+  tree.GetData("msg.b.value", data);
+  REQUIRE(data == 3);
+  tree.GetData("msg.a.value", data);
+  REQUIRE(data == 1);
+  tree.GetData("old.value", data);
+  REQUIRE(data == 4);
+  REQUIRE(tree.ListChildren("msg", children) == 2);
+  std::vector<NodePath<std::string>> changed;
+  tree.ListChanged(generation, changed);
+  REQUIRE(changed.size() == 4);
+
+  // Subscribers get the whole batch.
+  tree.subscriptions().Flush();
+  REQUIRE(events.size() == 4);
+  for (auto &event : events) {
+    REQUIRE(event.generation == generation + 1);
+  }
+
+  batch.clear();
+  REQUIRE(batch.empty());
+  tree.Apply(batch);
+  REQUIRE(tree.generation() == generation + 1);
+
+  // Paths that share part of a segment or are prefixes of each other, sets to one path repeated.
+  for (int i = 1; i <= 5; i++) {
+    batch.Set("x.a", i).Set("x.ab.c", 10 + i).Set("x", 20 + i).Set("x.a.c", 30 + i).Set("x.a-b", 40 + i);
+  }
+  tree.Apply(batch);
+  tree.GetData("x.a", data);
+  REQUIRE(data == 5);
+  tree.GetData("x.ab.c", data);
+  REQUIRE(data == 15);
+  tree.GetData("x", data);
+  REQUIRE(data == 25);
+  tree.GetData("x.a.c", data);
+  REQUIRE(data == 35);
+  tree.GetData("x.a-b", data);
+  REQUIRE(data == 45);
+  REQUIRE(tree.ListChildren("x", children) == 3);
+  REQUIRE(tree.ListChildren("x.ab", children) == 1);
+}
@@ -0,0 +1 @@
+#include "type_id.h"
@@ -0,0 +1 @@
+#include "write_batch.h"